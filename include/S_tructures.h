@@ -7,6 +7,11 @@
 #include <stdint.h>
 #endif
 
+#ifdef S_TRUCTURES_THREADS
+#include <stdatomic.h>
+#include <threads.h>
+#endif
+
 #ifdef _MSC_VER
 #define ST_NORETURN __declspec(noreturn)
 #else
@@ -15,6 +20,9 @@
 
 #define ST_TINY_MAP_CAPACITY (256)
 
+/// Assumed size of a CPU cache-line. Used for padding shared counters between threads.
+#define ST_CACHE_LINE_SIZE ((size_t)64)
+
 /// A unique identifier for a tiny-map entry.
 ///
 /// Use `StHashStr()` or `TinyDict*()` functions for indexing using string keys of arbitrary length.
@@ -28,12 +36,52 @@ typedef struct TinyBucket {
     size_t data_size;
 } TinyBucket;
 
+/// Alignment of bucket data packed into a shared slab, matching what `malloc` would give you.
+#define ST_TINY_SLAB_ALIGNMENT ((size_t)16)
+
+#define ST_TINY_FILTER_BITS_PER_ENTRY ((size_t)16)
+#define ST_TINY_FILTER_MIN_CAPACITY ((size_t)64)
+
+/// An optional blocked Bloom filter in front of a `TinyMap`, which lets most lookups of missing
+/// keys return after touching a single cache-line. You never interact with it directly.
+typedef struct TinyFilter TinyFilter;
+
+/// A shared allocation holding the data of several buckets copied over by `TinyMapMerge`. You never
+/// interact with it directly.
+typedef struct {
+    char* data;
+    size_t size;
+} TinySlab;
+
 /// A tiny hashmap-like structure indexed with 8-byte keys.
 typedef struct {
     TinyBucket** buckets;
     size_t length;
+    TinyFilter* filter;
+    TinySlab* slabs;
 } TinyMap;
 
+/// How `TinyMapMerge` resolves keys present in both maps.
+typedef enum {
+    /// Keep the destination's value when both maps have the same key.
+    ST_MERGE_KEEP,
+    /// Replace the destination's value with the source's one when both maps have the same key.
+    ST_MERGE_OVERWRITE,
+} TinyMergePolicy;
+
+/// Makes a byte-for-byte `copy` of an entry's data own copies of whatever the `original` refers to.
+typedef void (*TinyBucketCopy)(void* copy, const void* original);
+
+/// Lookup statistics of a tiny-map's filter.
+typedef struct {
+    /// Lookups that went through the filter.
+    size_t lookups;
+    /// Lookups which the filter answered with "definitely not here".
+    size_t rejected;
+    /// Lookups which the filter let through, but then found nothing.
+    size_t false_positives;
+} TinyFilterStats;
+
 /// An iterator over tiny-maps.
 typedef struct {
     TinyMap* source;
@@ -52,12 +100,41 @@ typedef struct {
 
 #define TINY_MAP_FOREACH(map, it) for (TinyMapIterator it = TinyMapIter((map)); TinyMapNext(&(it));)
 
+/// A dense identifier of a string stored inside an `StInterner`.
+typedef uint32_t StStrId;
+
+/// Returned by `StInternerFind` & `StInternerFindHash` when there is no such string.
+#define ST_STR_ID_NONE ((StStrId)UINT32_MAX)
+
+#define ST_INTERNER_CHUNK_SIZE ((size_t)4096)
+
+/// A string stored inside an `StInterner`. You never interact with it directly.
+typedef struct {
+    const char* str;
+    size_t length;
+    TinyHash hash;
+} StInterned;
+
+/// A string table which stores every distinct string once and hands out dense IDs for them.
+///
+/// Zero-initialize it just like a `TinyMap`.
+typedef struct {
+    StInterned* entries;
+    StStrId* slots;
+    size_t slot_count;
+    char** chunks;
+    size_t chunk_used, chunk_cap;
+} StInterner;
+
 /// Copy up to 8 bytes from a string and return them as an `StTinyKey`.
 TinyHash StStrKey(const char* s);
 
 /// Hash a string of arbitrary length into an `StTinyKey`.
 TinyHash StHashStr(const char* s);
 
+/// Same as `StHashStr`, but for strings that aren't NUL-terminated.
+TinyHash StHashStrN(const char* s, size_t len);
+
 /// Cleanup a `TinyMap`.
 void FreeTinyMap(TinyMap* that);
 
@@ -89,11 +166,57 @@ char* TinyMapGet(const TinyMap* that, TinyHash hash);
 #define TinyDictGet(that, hash) TinyMapGet((that), StHashStr((hash)))
 
 /// Free the bucket and the data associated with a key.
+///
+/// If the map has a filter, the erased key stays in it until enough keys are erased to warrant a
+/// rebuild. It can only cause a false-positive in the meantime.
 void TinyMapErase(TinyMap* that, TinyHash hash);
 
 /// An shorthand for `TinyMapErase` which accepts string keys and hashes them for you.
 #define TinyDictErase(that, hash) TinyMapErase((that), StHashStr((hash)))
 
+/// Puts a Bloom filter in front of the tiny-map's lookups, which pays off when most of them are
+/// misses. The filter is kept up to date by `TinyMapPut` and friends, grows with the map, and goes
+/// away along with it in `FreeTinyMap`.
+void TinyMapEnableFilter(TinyMap* that);
+
+/// Removes the tiny-map's filter, if any.
+void TinyMapDisableFilter(TinyMap* that);
+
+/// Rebuilds the tiny-map's filter from scratch, dropping the keys erased since the last rebuild.
+void TinyMapRebuildFilter(TinyMap* that);
+
+/// Returns the lookup statistics of the tiny-map's filter, or all zeroes if it has none or they
+/// are compiled out.
+///
+/// Statistics are only collected if you define `S_TRUCTURES_FILTER_STATS` next to
+/// `S_TRUCTURES_IMPLEMENTATION`, since counting makes every lookup write to memory shared by all
+/// threads. The counters are relaxed atomics when `S_TRUCTURES_THREADS` is defined. Without it,
+/// they are plain integers, and looking up keys in a filtered map from several threads is a data
+/// race.
+TinyFilterStats TinyMapFilterStats(const TinyMap* that);
+
+/// Returns the share of missing-key lookups which the filter failed to reject, or -1 if there's
+/// nothing to tell: the map has no filter, no misses were counted yet, or the statistics are
+/// compiled out because `S_TRUCTURES_FILTER_STATS` isn't defined (see above).
+double TinyMapFilterFalsePositiveRate(const TinyMap* that);
+
+/// Copies every entry of `src` into `dst`, resolving conflicting keys according to `policy`.
+///
+/// Data is copied byte-for-byte. Entries without a `cleanup` function are copied as-is. For the
+/// ones that have it, pass a `copy` function to deep-copy whatever their data refers to: the copies
+/// then get the same `cleanup` as the originals. Without `copy`, they get no `cleanup` and borrow
+/// from `src`, which must outlive them.
+///
+/// Chains are presized up front and all of the copied data is packed into a single allocation,
+/// which `dst` holds onto until it's freed. Overwriting a copied entry with data of another size or
+/// erasing it won't give that memory back before `FreeTinyMap`.
+void TinyMapMerge(TinyMap* dst, const TinyMap* src, TinyMergePolicy policy, TinyBucketCopy copy);
+
+/// Returns a new tiny-map with copies of every entry in `that`. See `TinyMapMerge` for the details.
+///
+/// The clone gets its own filter if the original has one.
+TinyMap TinyMapClone(const TinyMap* that, TinyBucketCopy copy);
+
 /// Creates an iterator over the values of a tiny-map.
 ///
 /// Pointer-cast and dereference `.data` to get the value of the current entry. Cast `.bucket` to
@@ -104,6 +227,133 @@ TinyMapIterator TinyMapIter(TinyMap* that);
 /// Otherwise returns false.
 bool TinyMapNext(TinyMapIterator* iter);
 
+#ifdef S_TRUCTURES_THREADS
+
+/// A set of worker threads which stay parked between parallel tiny-map operations, so that those
+/// don't pay for spawning threads on every call.
+typedef struct StThreadPool StThreadPool;
+
+/// Creates a thread pool which runs work on `nthreads` threads, including the calling one, i.e.
+/// `nthreads - 1` workers are spawned. Failing to spawn some of them only costs parallelism.
+StThreadPool* MakeStThreadPool(size_t nthreads);
+
+/// Stops and joins the pool's workers. Nothing may be running on the pool at this point.
+void FreeStThreadPool(StThreadPool* that);
+
+/// Returns the amount of threads the pool runs work on, including the calling one.
+size_t StThreadPoolSize(const StThreadPool* that);
+
+/// Inserts `n` key-value pairs into the tiny-map using the threads of `pool`, or just the calling
+/// thread if it's `NULL`. `values[i]` of `sizes[i]` bytes is stored under `keys[i]`; when a key
+/// repeats, the value that comes later in the input wins, just like with consecutive `TinyMapPut`s.
+///
+/// The input is partitioned by the map's internal chains, so each chain is only ever filled by a
+/// single thread at a time. Your `StAlloc` & `StFree` must be thread-safe.
+///
+/// A pool runs one operation at a time, so don't hand the same pool to concurrent callers.
+void TinyMapBuildParallel(TinyMap* that, const TinyHash* keys, const void* const* values,
+    const int* sizes, size_t n, StThreadPool* pool);
+
+/// Calls `fn` on every bucket of the tiny-map using the threads of `pool`, or just the calling
+/// thread if it's `NULL`. Chains are split evenly between the threads, which steal from each other
+/// once they're done with their share.
+///
+/// `fn` may modify the bucket's data, but must not put or erase anything in the map.
+void TinyMapParallelForEach(TinyMap* that, void (*fn)(TinyBucket* bucket, void* userdata),
+    void* userdata, StThreadPool* pool);
+
+/// A bounded lock-free queue for exactly one producer and one consumer thread.
+typedef struct TinySpscQ TinySpscQ;
+
+/// A bounded lock-free queue for any amount of producer and consumer threads.
+typedef struct TinyMpmcQ TinyMpmcQ;
+
+/// Creates a single-producer single-consumer queue. `capacity` is rounded up to a power of two.
+TinySpscQ* MakeTinySpscQPro(size_t capacity, size_t elt_size);
+
+/// A shorthand for `MakeTinySpscQPro` that takes the element-size from the passed type.
+#define MakeTinySpscQ(T, capacity) MakeTinySpscQPro((capacity), sizeof(T))
+
+/// Cleans up a single-producer single-consumer queue. Nobody may be using it at this point.
+void FreeTinySpscQ(TinySpscQ* that);
+
+/// Returns a specific property of an SPSC queue.
+size_t TinySpscQCapacity(const TinySpscQ* that), TinySpscQElementSize(const TinySpscQ* that);
+
+/// Copies an element into the queue. Returns false if the queue is full. Producer-only.
+bool TinySpscQPush(TinySpscQ* that, const void* ref);
+
+/// Copies the oldest element out of the queue. Returns false if the queue is empty. Consumer-only.
+bool TinySpscQPop(TinySpscQ* that, void* out);
+
+/// Pushes up to `count` contiguous elements at once and returns how many actually fit.
+size_t TinySpscQPushMany(TinySpscQ* that, const void* refs, size_t count);
+
+/// Pops up to `count` elements into contiguous storage at once and returns how many there were.
+size_t TinySpscQPopMany(TinySpscQ* that, void* out, size_t count);
+
+/// Creates a multi-producer multi-consumer queue. `capacity` is rounded up to a power of two.
+TinyMpmcQ* MakeTinyMpmcQPro(size_t capacity, size_t elt_size);
+
+/// A shorthand for `MakeTinyMpmcQPro` that takes the element-size from the passed type.
+#define MakeTinyMpmcQ(T, capacity) MakeTinyMpmcQPro((capacity), sizeof(T))
+
+/// Cleans up a multi-producer multi-consumer queue. Nobody may be using it at this point.
+void FreeTinyMpmcQ(TinyMpmcQ* that);
+
+/// Returns a specific property of an MPMC queue.
+size_t TinyMpmcQCapacity(const TinyMpmcQ* that), TinyMpmcQElementSize(const TinyMpmcQ* that);
+
+/// Copies an element into the queue. Returns false if the queue is full.
+bool TinyMpmcQPush(TinyMpmcQ* that, const void* ref);
+
+/// Copies the oldest element out of the queue. Returns false if the queue is empty.
+bool TinyMpmcQPop(TinyMpmcQ* that, void* out);
+
+/// Pushes up to `count` contiguous elements at once and returns how many actually fit. The pushed
+/// elements occupy consecutive slots, so they don't interleave with other producers' ones.
+size_t TinyMpmcQPushMany(TinyMpmcQ* that, const void* refs, size_t count);
+
+/// Pops up to `count` consecutive elements into contiguous storage at once and returns how many
+/// there were.
+size_t TinyMpmcQPopMany(TinyMpmcQ* that, void* out, size_t count);
+
+#endif
+
+/// Cleanup an `StInterner`. Every string it handed out is gone after this.
+void FreeStInterner(StInterner* that);
+
+/// Returns the amount of distinct strings inside this interner.
+size_t StInternerLength(const StInterner* that);
+
+/// Stores a copy of `len` bytes from `s` unless there's an identical string already, and returns
+/// its ID. IDs are handed out sequentially starting from 0.
+StStrId StIntern(StInterner* that, const char* s, size_t len);
+
+/// A shorthand for `StIntern` which accepts NUL-terminated strings.
+StStrId StInternStr(StInterner* that, const char* s);
+
+/// Looks up a string without storing it. Returns `ST_STR_ID_NONE` if there is none.
+StStrId StInternerFind(const StInterner* that, const char* s, size_t len);
+
+/// Looks up a string by its `StHashStr`, e.g. a key met while iterating a tiny-map which is keyed
+/// with `StInternerHash`. Returns `ST_STR_ID_NONE` if there is none. If several strings share the
+/// same hash, the earliest ID among them is returned.
+StStrId StInternerFindHash(const StInterner* that, TinyHash hash);
+
+/// Returns the NUL-terminated interned string, or `NULL` for an unknown ID. The pointer stays valid
+/// until the interner is freed.
+const char* StInternerStr(const StInterner* that, StStrId id);
+
+/// Returns the length of an interned string, not counting the NUL-terminator.
+size_t StInternerStrLength(const StInterner* that, StStrId id);
+
+/// Returns the precomputed `StHashStr` of an interned string. Use it with `TinyMap*` functions to
+/// skip rehashing the same string over and over again:
+///
+/// `TinyMapGet(&map, StInternerHash(&interner, id))` is equivalent to `TinyDictGet(&map, str)`.
+TinyHash StInternerHash(const StInterner* that, StStrId id);
+
 /// Creates a dynamic-array with the specified capacity and element-size.
 void* MakeTinyDPro(size_t capacity, size_t elt_size);
 
@@ -118,6 +368,10 @@ void FreeTinyD(void* that);
 size_t TinyDLength(const void* that), TinyDCapacity(const void* that),
     TinyDElementSize(const void* that);
 
+/// Grows a tiny-D so it can fit at least `capacity` elements without reallocating. DO NOT FORGET to
+/// assign the result of this to the array you passed in.
+void* TinyDReserve(void* that, size_t capacity);
+
 /// Appends an element to the dynamic-array, growing it if necessary. DO NOT FORGET to assign the
 /// result of this to the array you passed in.
 void* TinyDAppendPro(void* that, const void* ref);
@@ -147,6 +401,132 @@ void* TinyDPopFront(void* that);
 /// Pops the element at index `idx` and shifts the rest accordingly.
 void* TinyDErase(void* that, size_t idx);
 
+/// The default amount of children per node in tiny-heaps. Four keeps siblings within a cache-line
+/// for small elements while halving the tree's depth compared to a binary heap.
+#define ST_TINY_HEAP_ARITY ((size_t)4)
+
+/// Returned by `TinyHeapPush` when there's nowhere to push.
+#define ST_TINY_HEAP_NONE ((TinyHeapHandle)UINT64_MAX)
+
+/// Orders tiny-heap elements: returns a negative value if `a` should come out before `b`.
+typedef int (*TinyHeapCmp)(const void* a, const void* b);
+
+/// A stable reference to an element inside a tiny-heap, valid until the element is popped. Popped
+/// elements' handles stay invalid even after their storage gets reused by another push.
+typedef uint64_t TinyHeapHandle;
+
+/// A d-ary heap of elements of any fixed size, stored by value inside a tiny-D. Use it as a
+/// priority queue: the element which compares the lowest always comes out first.
+typedef struct {
+    char* items;
+    size_t *handles, *slots, *free_handles;
+    uint32_t* generations;
+    char* scratch;
+    TinyHeapCmp cmp;
+    size_t arity;
+} TinyHeap;
+
+/// Creates a tiny-heap with the specified element-size, arity, and comparator.
+TinyHeap MakeTinyHeapPro(size_t elt_size, size_t arity, TinyHeapCmp cmp);
+
+/// A shorthand for `MakeTinyHeapPro` that creates a 4-ary tiny-heap with the element-size equal to
+/// the size requirement of the passed type.
+#define MakeTinyHeap(T, cmp) MakeTinyHeapPro(sizeof(T), ST_TINY_HEAP_ARITY, (cmp))
+
+/// Turns an existing tiny-D into a tiny-heap in linear time. The heap takes ownership of the
+/// tiny-D, and each element's handle is its former index.
+TinyHeap TinyHeapFrom(void* tinyd, size_t arity, TinyHeapCmp cmp);
+
+/// Properly cleans up a tiny-heap.
+void FreeTinyHeap(TinyHeap* that);
+
+/// Returns the amount of elements inside this tiny-heap.
+size_t TinyHeapLength(const TinyHeap* that);
+
+/// Copies an element into the tiny-heap and returns its handle.
+TinyHeapHandle TinyHeapPush(TinyHeap* that, const void* ref);
+
+/// Returns a pointer to the element which would be popped next, or `NULL` if the heap is empty.
+void* TinyHeapPeek(const TinyHeap* that);
+
+/// Removes the top element, copying it into `out` unless it's `NULL`. Returns false if the heap is
+/// empty.
+bool TinyHeapPop(TinyHeap* that, void* out);
+
+/// Returns a pointer to the element behind a handle, or `NULL` if it has been popped already. DO
+/// NOT modify the element through it; use `TinyHeapUpdate` instead.
+void* TinyHeapGet(const TinyHeap* that, TinyHeapHandle handle);
+
+/// Replaces the element behind a handle and restores the heap order. This covers decrease-key as
+/// well as its opposite. Returns false if the handle has been popped already.
+bool TinyHeapUpdate(TinyHeap* that, TinyHeapHandle handle, const void* ref);
+
+/// Defines a set of `static` functions maintaining a plain tiny-D of `T` as a 4-ary heap with an
+/// inlined comparison, for when the generic `TinyHeap` is too slow. `less(a, b)` takes two values
+/// of type `T`. There are no handles, and the top element is simply `heap[0]`:
+///
+/// ```c
+/// #define TimerLess(a, b) ((a).deadline < (b).deadline)
+/// ST_DEFINE_TINY_HEAP(TimerHeap, Timer, TimerLess)
+///
+/// Timer* timers = MakeTinyD(Timer);
+/// timers = TimerHeapPush(timers, timer); // DO NOT FORGET to assign the result.
+/// Timer next = timers[0];
+/// timers = TimerHeapPop(timers);
+/// ```
+#define ST_DEFINE_TINY_HEAP(name, T, less)                                                         \
+    static inline void name##SiftUp(T* heap, size_t i) {                                           \
+        const T value = heap[i];                                                                   \
+        for (; i > 0; i = (i - 1) / ST_TINY_HEAP_ARITY) {                                          \
+            const size_t parent = (i - 1) / ST_TINY_HEAP_ARITY;                                    \
+            if (!(less(value, heap[parent])))                                                      \
+                break;                                                                             \
+            heap[i] = heap[parent];                                                                \
+        }                                                                                          \
+        heap[i] = value;                                                                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline void name##SiftDown(T* heap, size_t i) {                                         \
+        const size_t length = TinyDLength(heap);                                                   \
+        const T value = heap[i];                                                                   \
+        for (size_t first; (first = i * ST_TINY_HEAP_ARITY + 1) < length;) {                       \
+            const size_t end = first + ST_TINY_HEAP_ARITY < length ? first + ST_TINY_HEAP_ARITY    \
+                                                                   : length;                       \
+            size_t best = first;                                                                   \
+            for (size_t c = first + 1; c < end; c++)                                               \
+                if (less(heap[c], heap[best]))                                                     \
+                    best = c;                                                                      \
+            if (!(less(heap[best], value)))                                                        \
+                break;                                                                             \
+            heap[i] = heap[best], i = best;                                                        \
+        }                                                                                          \
+        heap[i] = value;                                                                           \
+    }                                                                                              \
+                                                                                                   \
+    static inline T* name##Push(T* heap, T value) {                                                \
+        heap = (T*)TinyDAppendPro(heap, &value);                                                   \
+        name##SiftUp(heap, TinyDLength(heap) - 1);                                                 \
+        return heap;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline T* name##Pop(T* heap) {                                                          \
+        const size_t length = TinyDLength(heap);                                                   \
+        if (!length)                                                                               \
+            return heap;                                                                           \
+        heap[0] = heap[length - 1];                                                                \
+        heap = (T*)TinyDPop(heap);                                                                 \
+        if (length > 1)                                                                            \
+            name##SiftDown(heap, 0);                                                               \
+        return heap;                                                                               \
+    }                                                                                              \
+                                                                                                   \
+    static inline T* name##Heapify(T* heap) {                                                      \
+        for (size_t i = TinyDLength(heap) / ST_TINY_HEAP_ARITY + 1; i-- > 0;)                      \
+            if (i < TinyDLength(heap))                                                             \
+                name##SiftDown(heap, i);                                                           \
+        return heap;                                                                               \
+    }
+
 #ifdef S_TRUCTURES_IMPLEMENTATION
 
 #if !defined(StAlloc) && !defined(StFree)
@@ -271,17 +651,61 @@ TinyHash StHashStr(const char* s) {
     return hash;
 }
 
+TinyHash StHashStrN(const char* s, size_t len) {
+    TinyHash hash = 0xcbf29ce484222325;
+    for (size_t i = 0; s && i < len; i++)
+        hash ^= ((const uint8_t*)s)[i], hash *= 0x00000100000001b3;
+    return hash;
+}
+
 static void StCleanupBucket(const TinyBucket* that) {
     if (that->cleanup && that->data)
         that->cleanup(that->data);
 }
 
-static void FreeTinyBucket(const TinyBucket* that) {
-    StCleanupBucket(that);
-    if (that->data)
+// Slabs are kept sorted by address, so that `TinySlabsOwn` can binary-search them.
+static TinySlab* TinySlabsInsert(TinySlab* slabs, TinySlab slab) {
+    if (!slabs)
+        slabs = (TinySlab*)MakeTinyDPro(1, sizeof(TinySlab));
+    slabs = (TinySlab*)TinyDAppendPro(slabs, &slab);
+
+    size_t i = TinyDLength(slabs) - 1;
+    for (; i && (uintptr_t)slabs[i - 1].data > (uintptr_t)slab.data; i--)
+        slabs[i] = slabs[i - 1];
+    slabs[i] = slab;
+
+    return slabs;
+}
+
+// Whether `data` lives in one of the slabs instead of its own allocation.
+static bool TinySlabsOwn(const TinySlab* slabs, const void* data) {
+    const uintptr_t addr = (uintptr_t)data;
+    size_t lo = 0, hi = TinyDLength(slabs);
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+
+        if (addr < (uintptr_t)slabs[mid].data)
+            hi = mid;
+        else if (addr >= (uintptr_t)slabs[mid].data + slabs[mid].size)
+            lo = mid + 1;
+        else
+            return true;
+    }
+
+    return false;
+}
+
+static void StFreeBucketData(const TinyBucket* that, const TinySlab* slabs) {
+    if (that->data && !TinySlabsOwn(slabs, that->data))
         StFree(that->data);
 }
 
+static void FreeTinyBucket(const TinyBucket* that, const TinySlab* slabs) {
+    StCleanupBucket(that);
+    StFreeBucketData(that, slabs);
+}
+
 void FreeTinyMap(TinyMap* that) {
     if (!that)
         return;
@@ -289,13 +713,18 @@ void FreeTinyMap(TinyMap* that) {
     if (that->buckets) {
         for (int i = 0; i < ST_TINY_MAP_CAPACITY; i++) {
             for (int j = 0; j < TinyDLength(that->buckets[i]); j++)
-                FreeTinyBucket(&that->buckets[i][j]);
+                FreeTinyBucket(&that->buckets[i][j], that->slabs);
             FreeTinyD(that->buckets[i]);
         }
 
         StFree((void*)that->buckets), that->buckets = NULL;
     }
 
+    for (size_t i = 0; i < TinyDLength(that->slabs); i++)
+        StFree(that->slabs[i].data);
+    FreeTinyD(that->slabs), that->slabs = NULL;
+
+    TinyMapDisableFilter(that);
     that->length = 0;
 }
 
@@ -303,35 +732,145 @@ size_t TinyMapLength(const TinyMap* that) {
     return that->length;
 }
 
-TinyBucket* TinyMapPut(TinyMap* that, TinyHash hash, const void* data, int size) {
-    if (size < 1) { // TODO: bar behind a debug build check?
-        StLog("Requested bucket size 0; catching on fire");
-        return NULL;
+// Each key sets `ST_TINY_FILTER_HASHES` bits inside one 512-bit block, so a lookup only ever
+// touches a single cache-line of the filter. The key is remixed first since plain integer keys
+// would otherwise leave most of the bits unused.
+#define ST_TINY_FILTER_BLOCK_WORDS ((size_t)8)
+#define ST_TINY_FILTER_HASHES (4)
+
+#if defined(S_TRUCTURES_FILTER_STATS) && defined(S_TRUCTURES_THREADS)
+typedef atomic_size_t StFilterCounter;
+#elif defined(S_TRUCTURES_FILTER_STATS)
+typedef size_t StFilterCounter;
+#endif
+
+struct TinyFilter {
+    uint64_t* blocks;
+    size_t block_mask, capacity, stale;
+#ifdef S_TRUCTURES_FILTER_STATS
+    StFilterCounter lookups, rejected, false_positives;
+#endif
+};
+
+#if !defined(S_TRUCTURES_FILTER_STATS)
+#define StFilterCount(counter) ((void)0)
+#define StFilterRead(counter) ((size_t)0)
+#elif defined(S_TRUCTURES_THREADS)
+#define StFilterCount(counter) atomic_fetch_add_explicit(&(counter), 1, memory_order_relaxed)
+#define StFilterRead(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+#else
+#define StFilterCount(counter) ((counter)++)
+#define StFilterRead(counter) (counter)
+#endif
+
+// Thanks: <https://prng.di.unimi.it/splitmix64.c>
+static uint64_t StMixKey(TinyHash hash) {
+    hash += 0x9e3779b97f4a7c15;
+    hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+    hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+    return hash ^ (hash >> 31);
+}
+
+static void TinyFilterAdd(TinyFilter* that, TinyHash hash) {
+    const uint64_t mixed = StMixKey(hash);
+    uint64_t* block = &that->blocks[(mixed & that->block_mask) * ST_TINY_FILTER_BLOCK_WORDS];
+
+    for (int i = 0; i < ST_TINY_FILTER_HASHES; i++) {
+        const size_t bit = (mixed >> (28 + 9 * i)) & 511;
+        block[bit / 64] |= (uint64_t)1 << (bit % 64);
     }
+}
 
-    if (!that->buckets) {
-        StCheckedAlloc(that->buckets, sizeof(TinyBucket*) * ST_TINY_MAP_CAPACITY);
-        StMemset((void*)that->buckets, 0, sizeof(TinyBucket*) * ST_TINY_MAP_CAPACITY);
+static bool TinyFilterMayContain(const TinyFilter* that, TinyHash hash) {
+    const uint64_t mixed = StMixKey(hash);
+    const uint64_t* block = &that->blocks[(mixed & that->block_mask) * ST_TINY_FILTER_BLOCK_WORDS];
+
+    for (int i = 0; i < ST_TINY_FILTER_HASHES; i++) {
+        const size_t bit = (mixed >> (28 + 9 * i)) & 511;
+        if (!(block[bit / 64] & ((uint64_t)1 << (bit % 64))))
+            return false;
     }
 
-    const size_t idx = TinyKey2Idx(hash);
+    return true;
+}
 
-    if (!that->buckets[idx])
-        that->buckets[idx] = MakeTinyD(TinyBucket);
+void TinyMapRebuildFilter(TinyMap* that) {
+    if (!that || !that->filter)
+        return;
+
+    TinyFilter* filter = that->filter;
+
+    // leave room for the map to double before the next rebuild:
+    size_t capacity = ST_TINY_FILTER_MIN_CAPACITY;
+    while (capacity < 2 * that->length)
+        capacity *= 2;
+
+    const size_t words = capacity * ST_TINY_FILTER_BITS_PER_ENTRY / 64;
+    if (capacity != filter->capacity) {
+        if (filter->blocks)
+            StFree(filter->blocks);
+        StCheckedAlloc(filter->blocks, sizeof(uint64_t) * words);
+        filter->capacity = capacity;
+        filter->block_mask = words / ST_TINY_FILTER_BLOCK_WORDS - 1;
+    }
+
+    StMemset(filter->blocks, 0, sizeof(uint64_t) * words);
+    filter->stale = 0;
+
+    TINY_MAP_FOREACH (that, it)
+        TinyFilterAdd(filter, it.bucket->hash);
+}
+
+void TinyMapEnableFilter(TinyMap* that) {
+    if (!that || that->filter)
+        return;
+
+    StCheckedAlloc(that->filter, sizeof(TinyFilter));
+    StMemset(that->filter, 0, sizeof(TinyFilter));
+    TinyMapRebuildFilter(that);
+}
+
+void TinyMapDisableFilter(TinyMap* that) {
+    if (!that || !that->filter)
+        return;
+
+    StFree(that->filter->blocks);
+    StFree(that->filter), that->filter = NULL;
+}
+
+TinyFilterStats TinyMapFilterStats(const TinyMap* that) {
+    TinyFilterStats stats = {0};
+
+    if (that && that->filter) {
+        stats.lookups = StFilterRead(that->filter->lookups);
+        stats.rejected = StFilterRead(that->filter->rejected);
+        stats.false_positives = StFilterRead(that->filter->false_positives);
+    }
+
+    return stats;
+}
+
+double TinyMapFilterFalsePositiveRate(const TinyMap* that) {
+    const TinyFilterStats stats = TinyMapFilterStats(that);
+    const size_t misses = stats.rejected + stats.false_positives;
+    return misses ? (double)stats.false_positives / (double)misses : -1.0;
+}
 
-    const size_t len = TinyDLength(that->buckets[idx]);
+// Puts data into a single chain, bumping `length` if a new bucket had to be appended. `slabs` are
+// the owning map's ones, which resized buckets mustn't free their old data from.
+static TinyBucket* TinyChainPut(TinyBucket** chain, const TinySlab* slabs, TinyHash hash,
+    const void* data, int size, size_t* length) {
+    const size_t len = TinyDLength(*chain);
 
     for (size_t i = 0; i < len; i++) {
-        TinyBucket* bucket = &that->buckets[idx][i];
+        TinyBucket* bucket = &(*chain)[i];
 
         if (bucket->hash == hash) {
             StCleanupBucket(bucket);
 
             if (bucket->data_size != (size_t)size) {
-                if (bucket->data) {
-                    StFree(bucket->data);
-                    bucket->data = NULL;
-                }
+                StFreeBucketData(bucket, slabs);
+                bucket->data = NULL;
 
                 StCheckedAlloc(bucket->data, size);
                 bucket->data_size = size;
@@ -348,22 +887,69 @@ TinyBucket* TinyMapPut(TinyMap* that, TinyHash hash, const void* data, int size)
     StCheckedAlloc(bucket.data, bucket.data_size);
     StMemcpy(bucket.data, data, bucket.data_size);
 
-    that->buckets[idx] = (TinyBucket*)TinyDAppendPro(that->buckets[idx], &bucket);
-    that->length++;
+    *chain = (TinyBucket*)TinyDAppendPro(*chain, &bucket);
+    (*length)++;
+
+    return &(*chain)[len];
+}
+
+static void TinyMapEnsureBuckets(TinyMap* that) {
+    if (!that->buckets) {
+        StCheckedAlloc(that->buckets, sizeof(TinyBucket*) * ST_TINY_MAP_CAPACITY);
+        StMemset((void*)that->buckets, 0, sizeof(TinyBucket*) * ST_TINY_MAP_CAPACITY);
+    }
+}
+
+TinyBucket* TinyMapPut(TinyMap* that, TinyHash hash, const void* data, int size) {
+    if (size < 1) { // TODO: bar behind a debug build check?
+        StLog("Requested bucket size 0; catching on fire");
+        return NULL;
+    }
+
+    TinyMapEnsureBuckets(that);
+
+    const size_t idx = TinyKey2Idx(hash);
+
+    if (!that->buckets[idx])
+        that->buckets[idx] = MakeTinyD(TinyBucket);
+
+    TinyBucket* bucket
+        = TinyChainPut(&that->buckets[idx], that->slabs, hash, data, size, &that->length);
+
+    if (that->filter) {
+        if (that->length > that->filter->capacity)
+            TinyMapRebuildFilter(that);
+        else
+            TinyFilterAdd(that->filter, hash);
+    }
 
-    return &that->buckets[idx][len];
+    return bucket;
 }
 
 TinyBucket* TinyMapFind(const TinyMap* that, TinyHash hash) {
     if (!that || !that->buckets)
         return NULL;
 
+    TinyFilter* const filter = that->filter;
+
+    if (filter) {
+        StFilterCount(filter->lookups);
+
+        if (!TinyFilterMayContain(filter, hash)) {
+            StFilterCount(filter->rejected);
+            return NULL;
+        }
+    }
+
     TinyBucket* buckets = that->buckets[TinyKey2Idx(hash)];
 
     for (size_t i = 0; i < TinyDLength(buckets); i++)
         if (buckets[i].hash == hash)
             return &buckets[i];
 
+    if (filter)
+        StFilterCount(filter->false_positives);
+
     return NULL;
 }
 
@@ -382,16 +968,128 @@ void TinyMapErase(TinyMap* that, TinyHash hash) {
 
     for (size_t i = 0; i < length; i++) {
         if (buckets[i].hash == hash) {
-            FreeTinyBucket(&buckets[i]);
+            FreeTinyBucket(&buckets[i], that->slabs);
             buckets[i] = buckets[length - 1];
             that->buckets[idx] = (TinyBucket*)TinyDPop(buckets);
             that->length--;
 
+            if (that->filter && ++that->filter->stale > that->filter->capacity / 2)
+                TinyMapRebuildFilter(that);
+
             break;
         }
     }
 }
 
+// Size of a bucket's data rounded up to keep the next one in a slab aligned.
+#define StSlabSize(size) (((size) + ST_TINY_SLAB_ALIGNMENT - 1) & ~(ST_TINY_SLAB_ALIGNMENT - 1))
+
+// Looks for a hash among the first `len` buckets of a chain.
+static TinyBucket* TinyChainFind(TinyBucket* chain, size_t len, TinyHash hash) {
+    for (size_t i = 0; i < len; i++)
+        if (chain[i].hash == hash)
+            return &chain[i];
+    return NULL;
+}
+
+void TinyMapMerge(TinyMap* dst, const TinyMap* src, TinyMergePolicy policy, TinyBucketCopy copy) {
+    if (!dst || !src || !src->buckets || dst == src)
+        return;
+
+    const bool overwrite = policy == ST_MERGE_OVERWRITE;
+    TinyMapEnsureBuckets(dst);
+
+    // first pass: figure out how much of the source's data needs fresh storage.
+    size_t slab_size = 0;
+
+    for (size_t i = 0; i < ST_TINY_MAP_CAPACITY; i++) {
+        const TinyBucket* chain = src->buckets[i];
+
+        for (size_t j = 0; j < TinyDLength(chain); j++) {
+            const TinyBucket* existing
+                = TinyChainFind(dst->buckets[i], TinyDLength(dst->buckets[i]), chain[j].hash);
+
+            if (!existing || (overwrite && existing->data_size != chain[j].data_size))
+                slab_size += StSlabSize(chain[j].data_size);
+        }
+    }
+
+    char* slab = NULL;
+
+    if (slab_size) {
+        StCheckedAlloc(slab, slab_size);
+        dst->slabs = TinySlabsInsert(dst->slabs, (TinySlab){.data = slab, .size = slab_size});
+    }
+
+    // second pass: copy everything over. Source chains never repeat a hash, so it's enough to
+    // compare against the destination's original entries.
+    for (size_t i = 0; i < ST_TINY_MAP_CAPACITY; i++) {
+        const TinyBucket* chain = src->buckets[i];
+        const size_t src_len = TinyDLength(chain);
+
+        if (!src_len)
+            continue;
+
+        TinyBucket** dst_chain = &dst->buckets[i];
+        const size_t dst_len = TinyDLength(*dst_chain);
+
+        if (!*dst_chain)
+            *dst_chain = (TinyBucket*)MakeTinyDPro(src_len, sizeof(TinyBucket));
+        else
+            *dst_chain = (TinyBucket*)TinyDReserve(*dst_chain, dst_len + src_len);
+
+        for (size_t j = 0; j < src_len; j++) {
+            const TinyBucket* from = &chain[j];
+            TinyBucket* to = TinyChainFind(*dst_chain, dst_len, from->hash);
+
+            if (to && !overwrite)
+                continue;
+
+            if (to) {
+                StCleanupBucket(to);
+
+                if (to->data_size != from->data_size) {
+                    StFreeBucketData(to, dst->slabs);
+                    to->data = slab;
+                    slab += StSlabSize(from->data_size);
+                }
+            } else {
+                const TinyBucket bucket = {.hash = from->hash, .data = slab};
+                slab += StSlabSize(from->data_size);
+
+                *dst_chain = (TinyBucket*)TinyDAppendPro(*dst_chain, &bucket);
+                to = &(*dst_chain)[TinyDLength(*dst_chain) - 1];
+                dst->length++;
+            }
+
+            StMemcpy(to->data, from->data, from->data_size);
+            to->data_size = from->data_size;
+            to->cleanup = copy ? from->cleanup : NULL;
+
+            if (copy && from->cleanup)
+                copy(to->data, from->data);
+
+            if (dst->filter && dst->length <= dst->filter->capacity)
+                TinyFilterAdd(dst->filter, to->hash);
+        }
+    }
+
+    if (dst->filter && dst->length > dst->filter->capacity)
+        TinyMapRebuildFilter(dst);
+}
+
+TinyMap TinyMapClone(const TinyMap* that, TinyBucketCopy copy) {
+    TinyMap result = {0};
+
+    if (that && that->filter)
+        TinyMapEnableFilter(&result);
+    TinyMapMerge(&result, that, ST_MERGE_KEEP, copy);
+
+    return result;
+}
+
+#undef StSlabSize
+
 bool TinyMapNext(TinyMapIterator* iter) {
     if (!iter->source || !iter->source->buckets)
         return false;
@@ -413,25 +1111,685 @@ TinyMapIterator TinyMapIter(TinyMap* that) {
     return (TinyMapIterator){.source = that};
 }
 
-size_t TinyDLength(const void* that) {
-    return TinyDGetHead(that) ? TinyDGetHead(that)->length : 0;
-}
+#ifdef S_TRUCTURES_THREADS
 
-size_t TinyDCapacity(const void* that) {
-    return TinyDGetHead(that) ? TinyDGetHead(that)->capacity : 0;
+// A slice of chains owned by a single worker. Other workers steal from its front once they run
+// out of their own, so `next` is shared and gets a cache-line to itself.
+typedef struct {
+    atomic_size_t next;
+    size_t end;
+    char pad[ST_CACHE_LINE_SIZE - sizeof(atomic_size_t) - sizeof(size_t)];
+} StChainRange;
+
+typedef struct {
+    StThreadPool* pool;
+    StChainRange* ranges;
+    size_t nranges, self;
+    void (*job)(void* ctx, size_t chain);
+    void* ctx;
+} StChainWorker;
+
+// Workers sleep on `wake` until `generation` changes, drain the chains, and report back through
+// `busy` & `done`. The calling thread always acts as worker #0.
+struct StThreadPool {
+    mtx_t lock;
+    cnd_t wake, done;
+    size_t generation, busy;
+    bool quit;
+
+    size_t spawned;
+    thrd_t* threads;
+    StChainRange* ranges;
+    StChainWorker* workers;
+};
+
+// Claims the next unprocessed chain, preferring the worker's own range. Returns
+// `ST_TINY_MAP_CAPACITY` once every range is drained.
+static size_t StClaimChain(const StChainWorker* worker) {
+    for (size_t i = 0; i < worker->nranges; i++) {
+        StChainRange* range = &worker->ranges[(worker->self + i) % worker->nranges];
+
+        if (atomic_load_explicit(&range->next, memory_order_relaxed) >= range->end)
+            continue;
+
+        const size_t chain = atomic_fetch_add_explicit(&range->next, 1, memory_order_relaxed);
+        if (chain < range->end)
+            return chain;
+    }
+
+    return ST_TINY_MAP_CAPACITY;
 }
 
-size_t TinyDElementSize(const void* that) {
-    return TinyDGetHead(that) ? TinyDGetHead(that)->elt_size : 0;
+static void StDrainChains(const StChainWorker* worker) {
+    for (size_t chain; (chain = StClaimChain(worker)) < ST_TINY_MAP_CAPACITY;)
+        worker->job(worker->ctx, chain);
 }
 
-void* MakeTinyDPro(size_t capacity, size_t elt_size) {
-    char* ptr = NULL;
-    StCheckedAlloc(ptr, sizeof(TinyDHead) + elt_size * capacity);
-    ptr += sizeof(TinyDHead);
+static int StThreadPoolMain(void* arg) {
+    const StChainWorker* worker = (const StChainWorker*)arg;
+    StThreadPool* pool = worker->pool;
+    size_t seen = 0;
 
-    TinyDGetHead(ptr)->length = 0, TinyDGetHead(ptr)->capacity = capacity;
-    TinyDGetHead(ptr)->elt_size = elt_size;
+    mtx_lock(&pool->lock);
+
+    for (;;) {
+        while (!pool->quit && pool->generation == seen)
+            cnd_wait(&pool->wake, &pool->lock);
+        if (pool->quit)
+            break;
+        seen = pool->generation;
+        mtx_unlock(&pool->lock);
+
+        StDrainChains(worker);
+
+        mtx_lock(&pool->lock);
+        if (!--pool->busy)
+            cnd_signal(&pool->done);
+    }
+
+    mtx_unlock(&pool->lock);
+    return 0;
+}
+
+StThreadPool* MakeStThreadPool(size_t nthreads) {
+    if (nthreads < 1)
+        nthreads = 1;
+    if (nthreads > ST_TINY_MAP_CAPACITY)
+        nthreads = ST_TINY_MAP_CAPACITY;
+
+    StThreadPool* that = NULL;
+    StCheckedAlloc(that, sizeof(*that));
+    StMemset(that, 0, sizeof(*that));
+
+    StCheckedAlloc(that->ranges, sizeof(*that->ranges) * nthreads);
+    StCheckedAlloc(that->workers, sizeof(*that->workers) * nthreads);
+    StCheckedAlloc(that->threads, sizeof(*that->threads) * nthreads);
+
+    for (size_t i = 0; i < nthreads; i++) {
+        atomic_init(&that->ranges[i].next, 0), that->ranges[i].end = 0;
+        that->workers[i] = (StChainWorker){.pool = that, .ranges = that->ranges, .self = i};
+    }
+
+    if (mtx_init(&that->lock, mtx_plain) != thrd_success || cnd_init(&that->wake) != thrd_success
+        || cnd_init(&that->done) != thrd_success)
+    {
+        StLog("Failed to set up a thread pool");
+        StDie();
+    }
+
+    for (that->spawned = 1; that->spawned < nthreads; that->spawned++)
+        if (thrd_create(&that->threads[that->spawned], StThreadPoolMain,
+                &that->workers[that->spawned])
+            != thrd_success)
+            break;
+
+    return that;
+}
+
+void FreeStThreadPool(StThreadPool* that) {
+    if (!that)
+        return;
+
+    mtx_lock(&that->lock);
+    that->quit = true;
+    cnd_broadcast(&that->wake);
+    mtx_unlock(&that->lock);
+
+    for (size_t i = 1; i < that->spawned; i++)
+        thrd_join(that->threads[i], NULL);
+
+    cnd_destroy(&that->done), cnd_destroy(&that->wake), mtx_destroy(&that->lock);
+    StFree(that->threads), StFree(that->workers), StFree(that->ranges), StFree(that);
+}
+
+size_t StThreadPoolSize(const StThreadPool* that) {
+    return that ? that->spawned : 1;
+}
+
+// Runs `job` once for every chain index, spread across the pool's threads. Without a pool, the
+// calling thread does everything on its own.
+static void StRunChainJob(StThreadPool* pool, void (*job)(void* ctx, size_t chain), void* ctx) {
+    if (!pool || pool->spawned < 2) {
+        for (size_t chain = 0; chain < ST_TINY_MAP_CAPACITY; chain++)
+            job(ctx, chain);
+        return;
+    }
+
+    // only hand out chains to the threads that actually exist:
+    const size_t nthreads = pool->spawned;
+
+    for (size_t i = 0; i < nthreads; i++) {
+        atomic_store_explicit(
+            &pool->ranges[i].next, i * ST_TINY_MAP_CAPACITY / nthreads, memory_order_relaxed);
+        pool->ranges[i].end = (i + 1) * ST_TINY_MAP_CAPACITY / nthreads;
+        pool->workers[i].nranges = nthreads, pool->workers[i].job = job, pool->workers[i].ctx = ctx;
+    }
+
+    // the lock publishes the setup above to the workers:
+    mtx_lock(&pool->lock);
+    pool->busy = nthreads - 1, pool->generation++;
+    cnd_broadcast(&pool->wake);
+    mtx_unlock(&pool->lock);
+
+    StDrainChains(&pool->workers[0]);
+
+    mtx_lock(&pool->lock);
+    while (pool->busy)
+        cnd_wait(&pool->done, &pool->lock);
+    mtx_unlock(&pool->lock);
+}
+
+typedef struct {
+    TinyBucket** buckets;
+    const TinySlab* slabs;
+    const TinyHash* keys;
+    const void* const* values;
+    const int* sizes;
+    const size_t *order, *offsets;
+} StBuildCtx;
+
+static void StBuildChain(void* arg, size_t chain) {
+    StBuildCtx* ctx = (StBuildCtx*)arg;
+    const size_t count = ctx->offsets[chain + 1] - ctx->offsets[chain];
+
+    if (!count)
+        return;
+
+    // the map's length gets recounted from the chains afterwards:
+    size_t added = 0;
+
+    TinyBucket** buckets = &ctx->buckets[chain];
+    if (!*buckets)
+        *buckets = (TinyBucket*)MakeTinyDPro(count, sizeof(TinyBucket));
+    else
+        *buckets = (TinyBucket*)TinyDReserve(*buckets, TinyDLength(*buckets) + count);
+
+    for (size_t i = ctx->offsets[chain]; i < ctx->offsets[chain + 1]; i++) {
+        const size_t entry = ctx->order[i];
+        TinyChainPut(buckets, ctx->slabs, ctx->keys[entry], ctx->values[entry], ctx->sizes[entry],
+            &added);
+    }
+}
+
+void TinyMapBuildParallel(TinyMap* that, const TinyHash* keys, const void* const* values,
+    const int* sizes, size_t n, StThreadPool* pool) {
+    if (!that || !n)
+        return;
+
+    size_t *order = NULL, *offsets = NULL;
+
+    StCheckedAlloc(order, sizeof(*order) * n);
+    StCheckedAlloc(offsets, sizeof(*offsets) * (ST_TINY_MAP_CAPACITY + 1));
+    StMemset(offsets, 0, sizeof(*offsets) * (ST_TINY_MAP_CAPACITY + 1));
+
+    // Counting-sort the input by chain index while keeping the original order within each chain,
+    // so duplicate keys resolve the same way as they would with serial puts.
+    for (size_t i = 0; i < n; i++) {
+        if (sizes[i] < 1) {
+            StLog("Requested bucket size 0; skipping entry %zu", i);
+            continue;
+        }
+        offsets[TinyKey2Idx(keys[i]) + 1]++;
+    }
+
+    for (size_t i = 0; i < ST_TINY_MAP_CAPACITY; i++)
+        offsets[i + 1] += offsets[i];
+
+    {
+        size_t cursor[ST_TINY_MAP_CAPACITY];
+        StMemcpy(cursor, offsets, sizeof(cursor));
+
+        for (size_t i = 0; i < n; i++)
+            if (sizes[i] >= 1)
+                order[cursor[TinyKey2Idx(keys[i])]++] = i;
+    }
+
+    TinyMapEnsureBuckets(that);
+
+    StBuildCtx ctx = {.buckets = that->buckets, .slabs = that->slabs, .keys = keys,
+        .values = values, .sizes = sizes, .order = order, .offsets = offsets};
+    StRunChainJob(pool, StBuildChain, &ctx);
+
+    that->length = 0;
+    for (size_t i = 0; i < ST_TINY_MAP_CAPACITY; i++)
+        that->length += TinyDLength(that->buckets[i]);
+
+    TinyMapRebuildFilter(that);
+
+    StFree(offsets), StFree(order);
+}
+
+typedef struct {
+    TinyBucket** buckets;
+    void (*fn)(TinyBucket*, void*);
+    void* userdata;
+} StForEachCtx;
+
+static void StForEachChain(void* arg, size_t chain) {
+    const StForEachCtx* ctx = (const StForEachCtx*)arg;
+    TinyBucket* buckets = ctx->buckets[chain];
+
+    for (size_t i = 0; i < TinyDLength(buckets); i++)
+        ctx->fn(&buckets[i], ctx->userdata);
+}
+
+void TinyMapParallelForEach(TinyMap* that, void (*fn)(TinyBucket* bucket, void* userdata),
+    void* userdata, StThreadPool* pool) {
+    if (!that || !that->buckets || !fn)
+        return;
+
+    StForEachCtx ctx = {.buckets = that->buckets, .fn = fn, .userdata = userdata};
+    StRunChainJob(pool, StForEachChain, &ctx);
+}
+
+static size_t StQueueCapacity(size_t capacity) {
+    size_t result = 1;
+    while (result < capacity)
+        result <<= 1;
+    return result;
+}
+
+// The producer and the consumer each own a cache-line with their own cursor and a stale copy of
+// the other one's, so they only touch each other's line when the cached value runs out.
+struct TinySpscQ {
+    size_t mask, elt_size;
+    char* cells;
+
+    char pad0[ST_CACHE_LINE_SIZE];
+    atomic_size_t head;
+    size_t cached_tail;
+
+    char pad1[ST_CACHE_LINE_SIZE];
+    atomic_size_t tail;
+    size_t cached_head;
+
+    char pad2[ST_CACHE_LINE_SIZE];
+};
+
+TinySpscQ* MakeTinySpscQPro(size_t capacity, size_t elt_size) {
+    capacity = StQueueCapacity(capacity);
+
+    TinySpscQ* that = NULL;
+    StCheckedAlloc(that, sizeof(*that) + capacity * elt_size);
+    StMemset(that, 0, sizeof(*that));
+
+    that->mask = capacity - 1, that->elt_size = elt_size;
+    that->cells = (char*)(that + 1);
+    atomic_init(&that->head, 0), atomic_init(&that->tail, 0);
+
+    return that;
+}
+
+void FreeTinySpscQ(TinySpscQ* that) {
+    if (that)
+        StFree(that);
+}
+
+size_t TinySpscQCapacity(const TinySpscQ* that) {
+    return that ? that->mask + 1 : 0;
+}
+
+size_t TinySpscQElementSize(const TinySpscQ* that) {
+    return that ? that->elt_size : 0;
+}
+
+// Copies `count` elements between the ring and flat storage, wrapping around the ring's end.
+static void StRingCopy(char* cells, size_t mask, size_t elt_size, size_t pos, char* flat,
+    size_t count, bool into_ring) {
+    const size_t start = pos & mask, first = count < mask + 1 - start ? count : mask + 1 - start;
+
+    if (into_ring) {
+        StMemcpy(cells + start * elt_size, flat, first * elt_size);
+        StMemcpy(cells, flat + first * elt_size, (count - first) * elt_size);
+    } else {
+        StMemcpy(flat, cells + start * elt_size, first * elt_size);
+        StMemcpy(flat + first * elt_size, cells, (count - first) * elt_size);
+    }
+}
+
+size_t TinySpscQPushMany(TinySpscQ* that, const void* refs, size_t count) {
+    const size_t tail = atomic_load_explicit(&that->tail, memory_order_relaxed);
+    const size_t capacity = that->mask + 1;
+
+    if (capacity - (tail - that->cached_head) < count)
+        that->cached_head = atomic_load_explicit(&that->head, memory_order_acquire);
+
+    const size_t room = capacity - (tail - that->cached_head);
+    if (count > room)
+        count = room;
+
+    if (count) {
+        StRingCopy(that->cells, that->mask, that->elt_size, tail, (char*)refs, count, true);
+        atomic_store_explicit(&that->tail, tail + count, memory_order_release);
+    }
+
+    return count;
+}
+
+size_t TinySpscQPopMany(TinySpscQ* that, void* out, size_t count) {
+    const size_t head = atomic_load_explicit(&that->head, memory_order_relaxed);
+
+    if (that->cached_tail - head < count)
+        that->cached_tail = atomic_load_explicit(&that->tail, memory_order_acquire);
+
+    const size_t available = that->cached_tail - head;
+    if (count > available)
+        count = available;
+
+    if (count) {
+        StRingCopy(that->cells, that->mask, that->elt_size, head, (char*)out, count, false);
+        atomic_store_explicit(&that->head, head + count, memory_order_release);
+    }
+
+    return count;
+}
+
+bool TinySpscQPush(TinySpscQ* that, const void* ref) {
+    return TinySpscQPushMany(that, ref, 1) == 1;
+}
+
+bool TinySpscQPop(TinySpscQ* that, void* out) {
+    return TinySpscQPopMany(that, out, 1) == 1;
+}
+
+// Dmitry Vyukov's bounded MPMC queue. Each cell carries a sequence number which tells whether it's
+// ready to be written or read on the current lap around the ring. Thanks:
+// <https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue>
+struct TinyMpmcQ {
+    size_t mask, elt_size, stride;
+    char* cells;
+
+    char pad0[ST_CACHE_LINE_SIZE];
+    atomic_size_t enqueue_pos;
+
+    char pad1[ST_CACHE_LINE_SIZE];
+    atomic_size_t dequeue_pos;
+
+    char pad2[ST_CACHE_LINE_SIZE];
+};
+
+#define StMpmcSeq(that, pos)                                                                       \
+    ((atomic_size_t*)((that)->cells + ((pos) & (that)->mask) * (that)->stride))
+#define StMpmcData(that, pos) ((char*)StMpmcSeq((that), (pos)) + sizeof(atomic_size_t))
+
+TinyMpmcQ* MakeTinyMpmcQPro(size_t capacity, size_t elt_size) {
+    capacity = StQueueCapacity(capacity);
+
+    // keep every cell's sequence number aligned:
+    const size_t align = sizeof(atomic_size_t);
+    const size_t stride = (sizeof(atomic_size_t) + elt_size + align - 1) / align * align;
+
+    TinyMpmcQ* that = NULL;
+    StCheckedAlloc(that, sizeof(*that) + capacity * stride);
+    StMemset(that, 0, sizeof(*that));
+
+    that->mask = capacity - 1, that->elt_size = elt_size, that->stride = stride;
+    that->cells = (char*)(that + 1);
+    atomic_init(&that->enqueue_pos, 0), atomic_init(&that->dequeue_pos, 0);
+
+    for (size_t i = 0; i < capacity; i++)
+        atomic_init(StMpmcSeq(that, i), i);
+
+    return that;
+}
+
+void FreeTinyMpmcQ(TinyMpmcQ* that) {
+    if (that)
+        StFree(that);
+}
+
+size_t TinyMpmcQCapacity(const TinyMpmcQ* that) {
+    return that ? that->mask + 1 : 0;
+}
+
+size_t TinyMpmcQElementSize(const TinyMpmcQ* that) {
+    return that ? that->elt_size : 0;
+}
+
+// Claims up to `count` consecutive cells starting at the shared cursor. A cell is claimable when
+// its sequence number equals its position plus `lag` (0 for producers, 1 for consumers). Only
+// whoever moves the cursor past a claimable cell may touch it, so checking before CAS is enough.
+static size_t StMpmcClaim(TinyMpmcQ* that, atomic_size_t* cursor, size_t lag, size_t count,
+    size_t* claimed) {
+    if (!count)
+        return 0;
+    if (count > that->mask + 1)
+        count = that->mask + 1;
+
+    size_t pos = atomic_load_explicit(cursor, memory_order_relaxed);
+
+    for (;;) {
+        size_t ready = 0;
+
+        for (; ready < count; ready++) {
+            const size_t seq
+                = atomic_load_explicit(StMpmcSeq(that, pos + ready), memory_order_acquire);
+            if (seq != pos + ready + lag)
+                break;
+        }
+
+        if (!ready) {
+            const size_t seq = atomic_load_explicit(StMpmcSeq(that, pos), memory_order_acquire);
+
+            // behind by a lap means full (or empty); anything else means we raced someone:
+            if ((ptrdiff_t)(seq - (pos + lag)) < 0)
+                return 0;
+
+            pos = atomic_load_explicit(cursor, memory_order_relaxed);
+            continue;
+        }
+
+        if (atomic_compare_exchange_weak_explicit(
+                cursor, &pos, pos + ready, memory_order_relaxed, memory_order_relaxed))
+        {
+            *claimed = pos;
+            return ready;
+        }
+    }
+}
+
+size_t TinyMpmcQPushMany(TinyMpmcQ* that, const void* refs, size_t count) {
+    size_t pos = 0;
+    count = StMpmcClaim(that, &that->enqueue_pos, 0, count, &pos);
+
+    for (size_t i = 0; i < count; i++) {
+        StMemcpy(StMpmcData(that, pos + i), (const char*)refs + i * that->elt_size, that->elt_size);
+        atomic_store_explicit(StMpmcSeq(that, pos + i), pos + i + 1, memory_order_release);
+    }
+
+    return count;
+}
+
+size_t TinyMpmcQPopMany(TinyMpmcQ* that, void* out, size_t count) {
+    size_t pos = 0;
+    count = StMpmcClaim(that, &that->dequeue_pos, 1, count, &pos);
+
+    for (size_t i = 0; i < count; i++) {
+        StMemcpy((char*)out + i * that->elt_size, StMpmcData(that, pos + i), that->elt_size);
+        atomic_store_explicit(
+            StMpmcSeq(that, pos + i), pos + i + that->mask + 1, memory_order_release);
+    }
+
+    return count;
+}
+
+bool TinyMpmcQPush(TinyMpmcQ* that, const void* ref) {
+    return TinyMpmcQPushMany(that, ref, 1) == 1;
+}
+
+bool TinyMpmcQPop(TinyMpmcQ* that, void* out) {
+    return TinyMpmcQPopMany(that, out, 1) == 1;
+}
+
+#undef StMpmcData
+#undef StMpmcSeq
+
+#endif // S_TRUCTURES_THREADS
+
+void FreeStInterner(StInterner* that) {
+    if (!that)
+        return;
+
+    for (size_t i = 0; i < TinyDLength(that->chunks); i++)
+        StFree(that->chunks[i]);
+
+    FreeTinyD(that->chunks), FreeTinyD(that->entries);
+    if (that->slots)
+        StFree(that->slots);
+
+    StMemset(that, 0, sizeof(*that));
+}
+
+size_t StInternerLength(const StInterner* that) {
+    return that ? TinyDLength(that->entries) : 0;
+}
+
+// Returns the slot where `s` lives, or the empty slot where it should go. The table is
+// open-addressed with linear probing, with slots holding `id + 1` so that zero means empty.
+static size_t StInternerProbe(const StInterner* that, const char* s, size_t len, TinyHash hash) {
+    const size_t mask = that->slot_count - 1;
+
+    for (size_t i = StShuffleKey(hash) & mask;; i = (i + 1) & mask) {
+        if (!that->slots[i])
+            return i;
+
+        const StInterned* entry = &that->entries[that->slots[i] - 1];
+        if (entry->hash != hash || entry->length != len)
+            continue;
+
+        size_t same = 0;
+        while (same < len && entry->str[same] == s[same])
+            same++;
+        if (same == len)
+            return i;
+    }
+}
+
+static void StInternerRehash(StInterner* that, size_t slot_count) {
+    StStrId* slots = NULL;
+    StCheckedAlloc(slots, sizeof(*slots) * slot_count);
+    StMemset(slots, 0, sizeof(*slots) * slot_count);
+
+    if (that->slots)
+        StFree(that->slots);
+    that->slots = slots, that->slot_count = slot_count;
+
+    for (size_t i = 0; i < TinyDLength(that->entries); i++) {
+        const StInterned* entry = &that->entries[i];
+        that->slots[StInternerProbe(that, entry->str, entry->length, entry->hash)] = i + 1;
+    }
+}
+
+// Bump-allocates a NUL-terminated copy of the string in the interner's arena.
+static const char* StInternerCopy(StInterner* that, const char* s, size_t len) {
+    if (!that->chunks)
+        that->chunks = MakeTinyD(char*);
+
+    if (that->chunk_used + len + 1 > that->chunk_cap) {
+        const size_t cap = len + 1 > ST_INTERNER_CHUNK_SIZE ? len + 1 : ST_INTERNER_CHUNK_SIZE;
+
+        char* chunk = NULL;
+        StCheckedAlloc(chunk, cap);
+        that->chunks = (char**)TinyDAppendPro(that->chunks, &chunk);
+        that->chunk_used = 0, that->chunk_cap = cap;
+    }
+
+    char* copy = that->chunks[TinyDLength(that->chunks) - 1] + that->chunk_used;
+    if (len)
+        StMemcpy(copy, s, len);
+    copy[len] = '\0';
+    that->chunk_used += len + 1;
+
+    return copy;
+}
+
+StStrId StIntern(StInterner* that, const char* s, size_t len) {
+    const TinyHash hash = StHashStrN(s, len);
+
+    if (!that->entries)
+        that->entries = MakeTinyD(StInterned);
+
+    // keep the table at most half-full:
+    if (2 * (TinyDLength(that->entries) + 1) > that->slot_count)
+        StInternerRehash(that, that->slot_count ? 2 * that->slot_count : 64);
+
+    const size_t slot = StInternerProbe(that, s, len, hash);
+    if (that->slots[slot])
+        return that->slots[slot] - 1;
+
+    const StStrId id = (StStrId)TinyDLength(that->entries);
+    if (id == ST_STR_ID_NONE) {
+        StLog("Interner ran out of string IDs");
+        StDie();
+    }
+
+    const StInterned entry = {.str = StInternerCopy(that, s, len), .length = len, .hash = hash};
+    that->entries = (StInterned*)TinyDAppendPro(that->entries, &entry);
+    that->slots[slot] = id + 1;
+
+    return id;
+}
+
+StStrId StInternStr(StInterner* that, const char* s) {
+    size_t len = 0;
+    while (s && s[len])
+        len++;
+    return StIntern(that, s, len);
+}
+
+StStrId StInternerFind(const StInterner* that, const char* s, size_t len) {
+    if (!that || !that->slots)
+        return ST_STR_ID_NONE;
+
+    const size_t slot = StInternerProbe(that, s, len, StHashStrN(s, len));
+    return that->slots[slot] ? that->slots[slot] - 1 : ST_STR_ID_NONE;
+}
+
+StStrId StInternerFindHash(const StInterner* that, TinyHash hash) {
+    if (!that || !that->slots)
+        return ST_STR_ID_NONE;
+
+    // strings with the same hash share a probe sequence, and the earlier ones sit closer to its
+    // start, rehashes included:
+    const size_t mask = that->slot_count - 1;
+    for (size_t i = StShuffleKey(hash) & mask; that->slots[i]; i = (i + 1) & mask)
+        if (that->entries[that->slots[i] - 1].hash == hash)
+            return that->slots[i] - 1;
+
+    return ST_STR_ID_NONE;
+}
+
+const char* StInternerStr(const StInterner* that, StStrId id) {
+    return id < StInternerLength(that) ? that->entries[id].str : NULL;
+}
+
+size_t StInternerStrLength(const StInterner* that, StStrId id) {
+    return id < StInternerLength(that) ? that->entries[id].length : 0;
+}
+
+TinyHash StInternerHash(const StInterner* that, StStrId id) {
+    return id < StInternerLength(that) ? that->entries[id].hash : 0;
+}
+
+size_t TinyDLength(const void* that) {
+    return TinyDGetHead(that) ? TinyDGetHead(that)->length : 0;
+}
+
+size_t TinyDCapacity(const void* that) {
+    return TinyDGetHead(that) ? TinyDGetHead(that)->capacity : 0;
+}
+
+size_t TinyDElementSize(const void* that) {
+    return TinyDGetHead(that) ? TinyDGetHead(that)->elt_size : 0;
+}
+
+void* MakeTinyDPro(size_t capacity, size_t elt_size) {
+    char* ptr = NULL;
+    StCheckedAlloc(ptr, sizeof(TinyDHead) + elt_size * capacity);
+    ptr += sizeof(TinyDHead);
+
+    TinyDGetHead(ptr)->length = 0, TinyDGetHead(ptr)->capacity = capacity;
+    TinyDGetHead(ptr)->elt_size = elt_size;
 
     return ptr;
 }
@@ -473,6 +1831,29 @@ void* TinyDErase(void* _this, size_t idx) {
     return TinyDPop(that);
 }
 
+void* TinyDReserve(void* _this, size_t capacity) {
+    char* that = (char*)_this;
+
+    if (!TinyDGetHead(that) || capacity <= TinyDGetHead(that)->capacity)
+        return that;
+
+    const size_t length = TinyDGetHead(that)->length;
+    const size_t elt_size = TinyDGetHead(that)->elt_size;
+
+    char* tmp = NULL;
+    StCheckedAlloc(tmp, elt_size * capacity + sizeof(TinyDHead));
+    tmp += sizeof(TinyDHead);
+
+    TinyDGetHead(tmp)->capacity = capacity;
+    TinyDGetHead(tmp)->length = length;
+    TinyDGetHead(tmp)->elt_size = elt_size;
+
+    StMemcpy(tmp, that, length * elt_size);
+    FreeTinyD(that);
+
+    return tmp;
+}
+
 void* TinyDAppendPro(void* _this, const void* ref) {
     char* that = (char*)_this;
 
@@ -483,28 +1864,215 @@ void* TinyDAppendPro(void* _this, const void* ref) {
     const size_t elt_size = TinyDGetHead(that)->elt_size;
     const size_t no_cap = TinyDGetHead(that)->capacity;
 
-    if (length == no_cap) {
-        const size_t newcap
-            = no_cap ? no_cap * ST_TINY_D_GROWTH_FACTOR : ST_TINY_D_INITIAL_CAPACITY;
+    if (length == no_cap)
+        that = (char*)TinyDReserve(
+            that, no_cap ? no_cap * ST_TINY_D_GROWTH_FACTOR : ST_TINY_D_INITIAL_CAPACITY);
+
+    StMemcpy(that + length * elt_size, ref, elt_size);
+    TinyDGetHead(that)->length += 1;
+
+    return that;
+}
+
+#define StHeapItem(that, slot) ((that)->items + (slot) * TinyDElementSize((that)->items))
 
-        char* tmp = NULL;
-        StCheckedAlloc(tmp, elt_size * newcap + sizeof(TinyDHead));
-        tmp += sizeof(TinyDHead);
+// Handles carry an index into `slots` in their low half, and the index's generation at the time of
+// the push in the high one. Popping bumps the generation, which invalidates the old handles.
+#define StHeapHandle(idx, gen) (((TinyHeapHandle)(gen) << 32) | (TinyHeapHandle)(idx))
+#define StHeapHandleIdx(handle) ((size_t)((handle) & UINT32_MAX))
+#define StHeapHandleGen(handle) ((uint32_t)((handle) >> 32))
 
-        TinyDGetHead(tmp)->capacity = newcap;
-        TinyDGetHead(tmp)->length = length;
-        TinyDGetHead(tmp)->elt_size = elt_size;
+// Moves the element at `slot` into a temporary and slides ancestors down into the hole until the
+// element fits, then drops it in. Keeps the handle<->slot mapping in sync along the way.
+static size_t TinyHeapSiftUp(TinyHeap* that, size_t slot) {
+    const size_t elt_size = TinyDElementSize(that->items);
+    const size_t handle = that->handles[slot];
+    StMemcpy(that->scratch, StHeapItem(that, slot), elt_size);
 
-        StMemcpy(tmp, that, no_cap * elt_size);
-        FreeTinyD(that), that = tmp;
+    while (slot > 0) {
+        const size_t parent = (slot - 1) / that->arity;
+        if (that->cmp(that->scratch, StHeapItem(that, parent)) >= 0)
+            break;
+
+        StMemcpy(StHeapItem(that, slot), StHeapItem(that, parent), elt_size);
+        that->handles[slot] = that->handles[parent];
+        that->slots[that->handles[slot]] = slot;
+        slot = parent;
     }
 
-    StMemcpy(that + length * elt_size, ref, elt_size);
-    TinyDGetHead(that)->length += 1;
+    StMemcpy(StHeapItem(that, slot), that->scratch, elt_size);
+    that->handles[slot] = handle, that->slots[handle] = slot;
+
+    return slot;
+}
+
+static void TinyHeapSiftDown(TinyHeap* that, size_t slot) {
+    const size_t elt_size = TinyDElementSize(that->items), length = TinyDLength(that->items);
+    const size_t handle = that->handles[slot];
+    StMemcpy(that->scratch, StHeapItem(that, slot), elt_size);
+
+    for (size_t first; (first = slot * that->arity + 1) < length;) {
+        const size_t end = first + that->arity < length ? first + that->arity : length;
+
+        size_t best = first;
+        for (size_t child = first + 1; child < end; child++)
+            if (that->cmp(StHeapItem(that, child), StHeapItem(that, best)) < 0)
+                best = child;
+
+        if (that->cmp(StHeapItem(that, best), that->scratch) >= 0)
+            break;
+
+        StMemcpy(StHeapItem(that, slot), StHeapItem(that, best), elt_size);
+        that->handles[slot] = that->handles[best];
+        that->slots[that->handles[slot]] = slot;
+        slot = best;
+    }
+
+    StMemcpy(StHeapItem(that, slot), that->scratch, elt_size);
+    that->handles[slot] = handle, that->slots[handle] = slot;
+}
+
+TinyHeap MakeTinyHeapPro(size_t elt_size, size_t arity, TinyHeapCmp cmp) {
+    return TinyHeapFrom(MakeTinyDPro(ST_TINY_D_INITIAL_CAPACITY, elt_size), arity, cmp);
+}
+
+TinyHeap TinyHeapFrom(void* tinyd, size_t arity, TinyHeapCmp cmp) {
+    TinyHeap that = {.items = (char*)tinyd, .cmp = cmp, .arity = arity < 2 ? 2 : arity};
+    if (!tinyd)
+        return that;
+
+    const size_t length = TinyDLength(that.items), capacity = TinyDCapacity(that.items);
+
+    that.handles = (size_t*)MakeTinyDPro(capacity, sizeof(size_t));
+    that.slots = (size_t*)MakeTinyDPro(capacity, sizeof(size_t));
+    that.free_handles = (size_t*)MakeTinyDPro(ST_TINY_D_INITIAL_CAPACITY, sizeof(size_t));
+    that.generations = (uint32_t*)MakeTinyDPro(capacity, sizeof(uint32_t));
+    StCheckedAlloc(that.scratch, TinyDElementSize(that.items));
+
+    // a handle of generation 0 is just its index:
+    const uint32_t generation = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        that.handles = (size_t*)TinyDAppendPro(that.handles, &i);
+        that.slots = (size_t*)TinyDAppendPro(that.slots, &i);
+        that.generations = (uint32_t*)TinyDAppendPro(that.generations, &generation);
+    }
+
+    // Floyd's method: sift down every parent, starting from the last one.
+    for (size_t i = length / that.arity + 1; i-- > 0;)
+        if (i < length)
+            TinyHeapSiftDown(&that, i);
 
     return that;
 }
 
+void FreeTinyHeap(TinyHeap* that) {
+    if (!that)
+        return;
+
+    FreeTinyD(that->items), FreeTinyD(that->handles);
+    FreeTinyD(that->slots), FreeTinyD(that->free_handles);
+    FreeTinyD(that->generations);
+    if (that->scratch)
+        StFree(that->scratch);
+
+    StMemset(that, 0, sizeof(*that));
+}
+
+size_t TinyHeapLength(const TinyHeap* that) {
+    return that ? TinyDLength(that->items) : 0;
+}
+
+TinyHeapHandle TinyHeapPush(TinyHeap* that, const void* ref) {
+    if (!that || !that->items)
+        return ST_TINY_HEAP_NONE;
+
+    const size_t slot = TinyDLength(that->items);
+    size_t handle = TinyDLength(that->slots);
+
+    if (TinyDLength(that->free_handles)) {
+        handle = that->free_handles[TinyDLength(that->free_handles) - 1];
+        that->free_handles = (size_t*)TinyDPop(that->free_handles);
+        that->slots[handle] = slot;
+    } else if (handle < UINT32_MAX) {
+        const uint32_t generation = 0;
+        that->slots = (size_t*)TinyDAppendPro(that->slots, &slot);
+        that->generations = (uint32_t*)TinyDAppendPro(that->generations, &generation);
+    } else {
+        StLog("Tiny-heap is out of handles; refusing to push");
+        return ST_TINY_HEAP_NONE;
+    }
+
+    that->items = (char*)TinyDAppendPro(that->items, ref);
+    that->handles = (size_t*)TinyDAppendPro(that->handles, &handle);
+    TinyHeapSiftUp(that, slot);
+
+    return StHeapHandle(handle, that->generations[handle]);
+}
+
+void* TinyHeapPeek(const TinyHeap* that) {
+    return TinyHeapLength(that) ? that->items : NULL;
+}
+
+bool TinyHeapPop(TinyHeap* that, void* out) {
+    const size_t length = TinyHeapLength(that);
+    if (!length)
+        return false;
+
+    if (out)
+        StMemcpy(out, that->items, TinyDElementSize(that->items));
+
+    const size_t popped = that->handles[0];
+    that->generations[popped]++;
+    that->free_handles = (size_t*)TinyDAppendPro(that->free_handles, &popped);
+
+    if (length > 1) {
+        StMemcpy(that->items, StHeapItem(that, length - 1), TinyDElementSize(that->items));
+        that->handles[0] = that->handles[length - 1];
+        that->slots[that->handles[0]] = 0;
+    }
+
+    that->items = (char*)TinyDPop(that->items);
+    that->handles = (size_t*)TinyDPop(that->handles);
+
+    if (length > 2)
+        TinyHeapSiftDown(that, 0);
+
+    return true;
+}
+
+void* TinyHeapGet(const TinyHeap* that, TinyHeapHandle handle) {
+    const size_t idx = StHeapHandleIdx(handle);
+
+    if (!that || idx >= TinyDLength(that->slots)
+        || that->generations[idx] != StHeapHandleGen(handle))
+        return NULL;
+
+    return StHeapItem(that, that->slots[idx]);
+}
+
+bool TinyHeapUpdate(TinyHeap* that, TinyHeapHandle handle, const void* ref) {
+    char* item = (char*)TinyHeapGet(that, handle);
+    if (!item)
+        return false;
+
+    const size_t slot = that->slots[StHeapHandleIdx(handle)];
+    StMemcpy(item, ref, TinyDElementSize(that->items));
+
+    // if it didn't move up, it might have to move down instead:
+    if (TinyHeapSiftUp(that, slot) == slot)
+        TinyHeapSiftDown(that, slot);
+
+    return true;
+}
+
+#undef StHeapItem
+#undef StHeapHandle
+#undef StHeapHandleIdx
+#undef StHeapHandleGen
+#undef StFilterRead
+#undef StFilterCount
+
 #undef TinyDGetHead
 #undef TinyKey2Idx
 
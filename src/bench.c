@@ -0,0 +1,393 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define S_TRUCTURES_IMPLEMENTATION
+#include "S_tructures.h"
+
+static double now() {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#define run_bench(fn) run_bench_fr(#fn, fn)
+static void run_bench_fr(const char* name, size_t (*fn)()) {
+    const double start = now();
+    const size_t ops = fn();
+    const double elapsed = now() - start;
+
+    printf("%-32s %10.3f ms %10.2f ns/op\n", name, elapsed * 1e3, elapsed * 1e9 / (double)ops);
+    fflush(stdout);
+}
+
+#define MAP_BENCH_ENTRIES ((size_t)100000)
+#define MAP_BENCH_LOOKUPS ((size_t)1000000)
+
+static size_t map_misses(bool filtered) {
+    TinyMap map = {0};
+    if (filtered)
+        TinyMapEnableFilter(&map);
+
+    for (size_t i = 0; i < MAP_BENCH_ENTRIES; i++)
+        TinyMapPut(&map, StHashStrN((const char*)&i, sizeof(i)), &i, sizeof(i));
+
+    volatile size_t found = 0;
+    for (size_t i = MAP_BENCH_ENTRIES; i < MAP_BENCH_ENTRIES + MAP_BENCH_LOOKUPS; i++)
+        found += TinyMapFind(&map, StHashStrN((const char*)&i, sizeof(i))) != NULL;
+
+    FreeTinyMap(&map);
+    return MAP_BENCH_LOOKUPS;
+}
+
+static size_t map_misses_unfiltered() {
+    return map_misses(false);
+}
+
+static size_t map_misses_filtered() {
+    return map_misses(true);
+}
+
+#define PROTOTYPE_BENCH_ENTRIES ((size_t)64)
+#define PROTOTYPE_BENCH_COPIES ((size_t)20000)
+
+typedef struct {
+    float x, y, z, w;
+    int64_t extra[2];
+} PrototypeProperty;
+
+static TinyMap make_prototype() {
+    TinyMap prototype = {0};
+    for (size_t i = 0; i < PROTOTYPE_BENCH_ENTRIES; i++) {
+        const PrototypeProperty prop = {.x = (float)i};
+        TinyMapPut(&prototype, StHashStrN((const char*)&i, sizeof(i)), &prop, sizeof(prop));
+    }
+    return prototype;
+}
+
+static size_t map_copy_via_foreach() {
+    TinyMap prototype = make_prototype();
+
+    for (size_t i = 0; i < PROTOTYPE_BENCH_COPIES; i++) {
+        TinyMap copy = {0};
+        TINY_MAP_FOREACH (&prototype, it)
+            TinyMapPut(&copy, it.bucket->hash, it.data, (int)it.bucket->data_size);
+        FreeTinyMap(&copy);
+    }
+
+    FreeTinyMap(&prototype);
+    return PROTOTYPE_BENCH_COPIES;
+}
+
+static size_t map_copy_via_clone() {
+    TinyMap prototype = make_prototype();
+
+    for (size_t i = 0; i < PROTOTYPE_BENCH_COPIES; i++) {
+        TinyMap copy = TinyMapClone(&prototype, NULL);
+        FreeTinyMap(&copy);
+    }
+
+    FreeTinyMap(&prototype);
+    return PROTOTYPE_BENCH_COPIES;
+}
+
+static void bench_maps() {
+    run_bench(map_misses_unfiltered);
+    run_bench(map_misses_filtered);
+    run_bench(map_copy_via_foreach);
+    run_bench(map_copy_via_clone);
+}
+
+#define HEAP_BENCH_SIZE ((size_t)10000)
+#define HEAP_BENCH_OPS ((size_t)20000)
+
+typedef struct {
+    uint64_t deadline;
+    size_t id;
+} Timer;
+
+// Deterministic pseudo-random deadlines, so that every contestant gets the same workload.
+static uint64_t next_deadline(uint64_t* state) {
+    *state ^= *state << 13, *state ^= *state >> 7, *state ^= *state << 17;
+    return *state % 1000000;
+}
+
+static int cmp_timers(const void* a, const void* b) {
+    const uint64_t x = ((const Timer*)a)->deadline, y = ((const Timer*)b)->deadline;
+    return (x > y) - (x < y);
+}
+
+// The baseline: a tiny-D kept sorted by insertion, popped from the front.
+static Timer* sorted_d_push(Timer* timers, Timer timer) {
+    size_t lo = 0, hi = TinyDLength(timers);
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (timers[mid].deadline <= timer.deadline)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    timers = TinyDAppendPro(timers, &timer);
+    memmove(&timers[lo + 1], &timers[lo], sizeof(Timer) * (TinyDLength(timers) - 1 - lo));
+    timers[lo] = timer;
+
+    return timers;
+}
+
+static size_t heap_sorted_d() {
+    uint64_t state = 1, sum = 0;
+    Timer* timers = MakeTinyD(Timer);
+
+    for (size_t i = 0; i < HEAP_BENCH_SIZE; i++)
+        timers = sorted_d_push(timers, (Timer){next_deadline(&state), i});
+
+    for (size_t i = 0; i < HEAP_BENCH_OPS; i++) {
+        sum += timers[0].deadline;
+        timers = TinyDErase(timers, 0);
+        timers = sorted_d_push(timers, (Timer){sum + next_deadline(&state), i});
+    }
+
+    FreeTinyD(timers);
+    return HEAP_BENCH_OPS;
+}
+
+static size_t heap_generic() {
+    uint64_t state = 1, sum = 0;
+    TinyHeap timers = MakeTinyHeap(Timer, cmp_timers);
+
+    for (size_t i = 0; i < HEAP_BENCH_SIZE; i++)
+        TinyHeapPush(&timers, &(Timer){next_deadline(&state), i});
+
+    for (size_t i = 0; i < HEAP_BENCH_OPS; i++) {
+        Timer top;
+        TinyHeapPop(&timers, &top);
+        sum += top.deadline;
+        TinyHeapPush(&timers, &(Timer){sum + next_deadline(&state), i});
+    }
+
+    FreeTinyHeap(&timers);
+    return HEAP_BENCH_OPS;
+}
+
+#define TimerLess(a, b) ((a).deadline < (b).deadline)
+ST_DEFINE_TINY_HEAP(TimerHeap, Timer, TimerLess)
+
+static size_t heap_specialized() {
+    uint64_t state = 1, sum = 0;
+    Timer* timers = MakeTinyD(Timer);
+
+    for (size_t i = 0; i < HEAP_BENCH_SIZE; i++)
+        timers = TimerHeapPush(timers, (Timer){next_deadline(&state), i});
+
+    for (size_t i = 0; i < HEAP_BENCH_OPS; i++) {
+        sum += timers[0].deadline;
+        timers = TimerHeapPop(timers);
+        timers = TimerHeapPush(timers, (Timer){sum + next_deadline(&state), i});
+    }
+
+    FreeTinyD(timers);
+    return HEAP_BENCH_OPS;
+}
+
+static void bench_heaps() {
+    run_bench(heap_sorted_d);
+    run_bench(heap_generic);
+    run_bench(heap_specialized);
+}
+
+#ifdef S_TRUCTURES_THREADS
+
+#define QUEUE_BENCH_ITEMS ((size_t)2000000)
+#define QUEUE_BENCH_CAPACITY ((size_t)1024)
+#define QUEUE_BENCH_BATCH ((size_t)32)
+
+// The baseline: a tiny-D guarded by a mutex, which is what people roll on their own.
+typedef struct {
+    mtx_t lock;
+    size_t* items;
+} LockedD;
+
+static bool LockedDPush(LockedD* q, size_t value) {
+    mtx_lock(&q->lock);
+    const bool fits = TinyDLength(q->items) < QUEUE_BENCH_CAPACITY;
+    if (fits)
+        q->items = TinyDAppend(q->items, value);
+    mtx_unlock(&q->lock);
+    return fits;
+}
+
+static bool LockedDPop(LockedD* q, size_t* out) {
+    mtx_lock(&q->lock);
+    const bool some = TinyDLength(q->items) > 0;
+    if (some)
+        *out = q->items[0], q->items = TinyDPopFront(q->items);
+    mtx_unlock(&q->lock);
+    return some;
+}
+
+static int locked_d_producer(void* arg) {
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;)
+        if (LockedDPush(arg, i))
+            i++;
+        else
+            thrd_yield();
+    return 0;
+}
+
+static size_t locked_d_1p1c() {
+    LockedD q = {.items = MakeTinyDPro(QUEUE_BENCH_CAPACITY, sizeof(size_t))};
+    mtx_init(&q.lock, mtx_plain);
+
+    thrd_t producer;
+    thrd_create(&producer, locked_d_producer, &q);
+
+    for (size_t i = 0, out = 0; i < QUEUE_BENCH_ITEMS;)
+        if (LockedDPop(&q, &out))
+            i++;
+        else
+            thrd_yield();
+
+    thrd_join(producer, NULL);
+    mtx_destroy(&q.lock), FreeTinyD(q.items);
+    return QUEUE_BENCH_ITEMS;
+}
+
+static int spsc_producer(void* arg) {
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;)
+        if (TinySpscQPush(arg, &i))
+            i++;
+        else
+            thrd_yield();
+    return 0;
+}
+
+static size_t spsc_1p1c() {
+    TinySpscQ* q = MakeTinySpscQ(size_t, QUEUE_BENCH_CAPACITY);
+
+    thrd_t producer;
+    thrd_create(&producer, spsc_producer, q);
+
+    for (size_t i = 0, out = 0; i < QUEUE_BENCH_ITEMS;)
+        if (TinySpscQPop(q, &out))
+            i++;
+        else
+            thrd_yield();
+
+    thrd_join(producer, NULL);
+    FreeTinySpscQ(q);
+    return QUEUE_BENCH_ITEMS;
+}
+
+static int spsc_batch_producer(void* arg) {
+    size_t batch[QUEUE_BENCH_BATCH] = {0};
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;) {
+        const size_t left = QUEUE_BENCH_ITEMS - i;
+        const size_t pushed = TinySpscQPushMany(
+            arg, batch, left < QUEUE_BENCH_BATCH ? left : QUEUE_BENCH_BATCH);
+        if (!pushed)
+            thrd_yield();
+        i += pushed;
+    }
+    return 0;
+}
+
+static size_t spsc_1p1c_batched() {
+    TinySpscQ* q = MakeTinySpscQ(size_t, QUEUE_BENCH_CAPACITY);
+
+    thrd_t producer;
+    thrd_create(&producer, spsc_batch_producer, q);
+
+    size_t batch[QUEUE_BENCH_BATCH];
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;) {
+        const size_t popped = TinySpscQPopMany(q, batch, QUEUE_BENCH_BATCH);
+        if (!popped)
+            thrd_yield();
+        i += popped;
+    }
+
+    thrd_join(producer, NULL);
+    FreeTinySpscQ(q);
+    return QUEUE_BENCH_ITEMS;
+}
+
+static int mpmc_producer(void* arg) {
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;)
+        if (TinyMpmcQPush(arg, &i))
+            i++;
+        else
+            thrd_yield();
+    return 0;
+}
+
+static size_t mpmc_1p1c() {
+    TinyMpmcQ* q = MakeTinyMpmcQ(size_t, QUEUE_BENCH_CAPACITY);
+
+    thrd_t producer;
+    thrd_create(&producer, mpmc_producer, q);
+
+    for (size_t i = 0, out = 0; i < QUEUE_BENCH_ITEMS;)
+        if (TinyMpmcQPop(q, &out))
+            i++;
+        else
+            thrd_yield();
+
+    thrd_join(producer, NULL);
+    FreeTinyMpmcQ(q);
+    return QUEUE_BENCH_ITEMS;
+}
+
+static int mpmc_batch_producer(void* arg) {
+    size_t batch[QUEUE_BENCH_BATCH] = {0};
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;) {
+        const size_t left = QUEUE_BENCH_ITEMS - i;
+        const size_t pushed = TinyMpmcQPushMany(
+            arg, batch, left < QUEUE_BENCH_BATCH ? left : QUEUE_BENCH_BATCH);
+        if (!pushed)
+            thrd_yield();
+        i += pushed;
+    }
+    return 0;
+}
+
+static size_t mpmc_1p1c_batched() {
+    TinyMpmcQ* q = MakeTinyMpmcQ(size_t, QUEUE_BENCH_CAPACITY);
+
+    thrd_t producer;
+    thrd_create(&producer, mpmc_batch_producer, q);
+
+    size_t batch[QUEUE_BENCH_BATCH];
+    for (size_t i = 0; i < QUEUE_BENCH_ITEMS;) {
+        const size_t popped = TinyMpmcQPopMany(q, batch, QUEUE_BENCH_BATCH);
+        if (!popped)
+            thrd_yield();
+        i += popped;
+    }
+
+    thrd_join(producer, NULL);
+    FreeTinyMpmcQ(q);
+    return QUEUE_BENCH_ITEMS;
+}
+
+static void bench_queues() {
+    run_bench(locked_d_1p1c);
+    run_bench(spsc_1p1c);
+    run_bench(spsc_1p1c_batched);
+    run_bench(mpmc_1p1c);
+    run_bench(mpmc_1p1c_batched);
+}
+
+#endif
+
+int main(int argc, char* argv[]) {
+    (void)argc, (void)argv;
+
+    bench_maps();
+    bench_heaps();
+
+#ifdef S_TRUCTURES_THREADS
+    bench_queues();
+#endif
+
+    return EXIT_SUCCESS;
+}
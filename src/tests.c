@@ -1,7 +1,9 @@
+#include <stdatomic.h>
 #include <stdio.h>
 #include <stdlib.h>
 
-static int malloc_counter = 0;
+// Atomic since the multithreaded extensions allocate from several threads at once.
+static atomic_int malloc_counter = 0;
 
 static void* counted_malloc(int size) {
     malloc_counter++;
@@ -14,6 +16,7 @@ static void counted_free(void* ptr) {
 }
 
 #define S_TRUCTURES_IMPLEMENTATION
+#define S_TRUCTURES_FILTER_STATS
 #define StAlloc counted_malloc
 #define StFree counted_free
 #include "S_tructures.h"
@@ -27,7 +30,7 @@ static void run_test_fr(const char* name, void (*fn)()) {
     malloc_counter = 0;
     fn();
     if (malloc_counter) {
-        printf("FAIL: leaked %d allocations\n", malloc_counter);
+        printf("FAIL: leaked %d allocations\n", (int)malloc_counter);
         fflush(stdout), exit(EXIT_FAILURE);
     }
 
@@ -153,6 +156,280 @@ static void map_safe_to_reuse() {
     reuse_map(&map);
 }
 
+#ifdef S_TRUCTURES_THREADS
+
+static void map_builds_in_parallel() {
+    const size_t count = 4096;
+    TinyMap map = {0};
+
+    TinyHash* keys = malloc(sizeof(*keys) * count);
+    const void** values = malloc(sizeof(*values) * count);
+    int* sizes = malloc(sizeof(*sizes) * count);
+    int32_t* data = malloc(sizeof(*data) * count);
+
+    // every key appears twice; the later value should win:
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = i % (count / 2), data[i] = (int32_t)i;
+        values[i] = &data[i], sizes[i] = sizeof(data[i]);
+    }
+
+    StThreadPool* pool = MakeStThreadPool(4);
+    TinyMapBuildParallel(&map, keys, values, sizes, count, pool);
+    assert_eq(TinyMapLength(&map), count / 2);
+
+    for (size_t i = 0; i < count / 2; i++)
+        assert_eq(TinyMapGetI32(&map, i), (int32_t)(i + count / 2));
+
+    // building on top of existing entries, without a pool this time:
+    TinyMapBuildParallel(&map, keys, values, sizes, count, NULL);
+    assert_eq(TinyMapLength(&map), count / 2);
+
+    free(data), free(sizes), free(values), free(keys);
+    FreeStThreadPool(pool);
+    FreeTinyMap(&map);
+}
+
+static void increment_bucket(TinyBucket* bucket, void* userdata) {
+    (*(int32_t*)bucket->data)++;
+    atomic_fetch_add((atomic_size_t*)userdata, 1);
+}
+
+static void map_iterates_in_parallel() {
+    const size_t count = 1024;
+    TinyMap map = {0};
+
+    for (size_t i = 0; i < count; i++) {
+        const int32_t data = (int32_t)i;
+        TinyMapPut(&map, i, &data, sizeof(data));
+    }
+
+    // the same pool gets reused across passes:
+    StThreadPool* pool = MakeStThreadPool(8);
+    atomic_size_t visited = 0;
+
+    for (int pass = 1; pass <= 10; pass++) {
+        TinyMapParallelForEach(&map, increment_bucket, &visited, pool);
+        assert_eq(visited, pass * count);
+    }
+
+    for (size_t i = 0; i < count; i++)
+        assert_eq(TinyMapGetI32(&map, i), (int32_t)(i + 10));
+
+    FreeStThreadPool(pool);
+    FreeTinyMap(&map);
+}
+
+#endif
+
+static void map_filter_rejects_misses() {
+    const size_t count = 1000;
+    TinyMap map = {0};
+
+    for (size_t i = 0; i < count / 2; i++) {
+        const int32_t data = (int32_t)i;
+        TinyMapPut(&map, i, &data, sizeof(data));
+    }
+
+    TinyMapEnableFilter(&map);
+    assert_eq(TinyMapFilterFalsePositiveRate(&map), -1.0);
+
+    // the filter has to grow along the way:
+    for (size_t i = count / 2; i < count; i++) {
+        const int32_t data = (int32_t)i;
+        TinyMapPut(&map, i, &data, sizeof(data));
+    }
+
+    for (size_t i = 0; i < count; i++)
+        assert_eq(TinyMapGetI32(&map, i), (int32_t)i);
+
+    for (size_t i = count; i < 100 * count; i++)
+        assert_eq(TinyMapFind(&map, i), NULL);
+
+    const TinyFilterStats stats = TinyMapFilterStats(&map);
+    assert_eq(stats.lookups, 100 * count);
+    assert_eq(stats.rejected + stats.false_positives, 99 * count);
+    assert_eq(TinyMapFilterFalsePositiveRate(&map) >= 0.0, true);
+    assert_eq(TinyMapFilterFalsePositiveRate(&map) < 0.05, true);
+
+    FreeTinyMap(&map);
+    assert_eq(map.filter, NULL);
+}
+
+static void map_filter_survives_erases() {
+    const size_t count = 1000;
+    TinyMap map = {0};
+    TinyMapEnableFilter(&map);
+
+    for (size_t i = 0; i < count; i++) {
+        const int32_t data = (int32_t)i;
+        TinyMapPut(&map, i, &data, sizeof(data));
+    }
+
+    // enough to trigger a rebuild:
+    for (size_t i = 0; i < count; i += 2)
+        TinyMapErase(&map, i);
+
+    for (size_t i = 0; i < count; i++)
+        assert_eq(TinyMapGetI32(&map, i), i % 2 ? (int32_t)i : 0);
+
+    TinyMapDisableFilter(&map);
+    assert_eq(TinyMapGetI32(&map, 1), 1);
+    assert_eq(TinyMapFilterStats(&map).lookups, 0);
+
+    FreeTinyMap(&map);
+}
+
+static int cleanup_counter = 0;
+
+static void count_cleanup(void* data) {
+    (void)data;
+    cleanup_counter++;
+}
+
+static void map_clones_independently() {
+    const size_t count = 1000;
+    TinyMap map = {0};
+
+    for (size_t i = 0; i < count; i++) {
+        const int64_t data = (int64_t)i;
+        TinyMapPut(&map, i, &data, i % 3 ? sizeof(data) : sizeof(int32_t))->cleanup
+            = count_cleanup;
+    }
+
+    TinyMap clone = TinyMapClone(&map, NULL);
+    assert_eq(TinyMapLength(&clone), count);
+
+    TINY_MAP_FOREACH (&clone, it) {
+        const TinyBucket* original = TinyMapFind(&map, it.bucket->hash);
+        assert_eq(it.bucket->data_size, original->data_size);
+        assert_eq(it.bucket->cleanup, NULL);
+        assert_eq((uintptr_t)it.data % ST_TINY_SLAB_ALIGNMENT, 0);
+    }
+
+    // copies are separate from the original, and can be overwritten & erased like any other entry:
+    const int64_t changed = -1;
+    TinyMapPut(&clone, 1, &changed, sizeof(changed));
+    TinyMapPut(&clone, 3, &changed, sizeof(changed));
+    TinyMapErase(&clone, 2);
+
+    assert_eq(TinyMapGetI64(&clone, 1), -1);
+    assert_eq(TinyMapGetI32(&clone, 3), -1);
+    assert_eq(TinyMapGet(&clone, 2), NULL);
+    assert_eq(TinyMapGetI64(&map, 1), 1);
+    assert_eq(TinyMapGetI32(&map, 3), 3);
+    assert_eq(TinyMapGetI64(&map, 2), 2);
+
+    cleanup_counter = 0;
+    FreeTinyMap(&clone);
+    assert_eq(cleanup_counter, 0);
+
+    FreeTinyMap(&map);
+    assert_eq(cleanup_counter, count);
+}
+
+static void free_boxed_int(void* data) {
+    StFree(*(int32_t**)data);
+}
+
+static void copy_boxed_int(void* copy, const void* original) {
+    int32_t* box = StAlloc(sizeof(*box));
+    *box = **(int32_t* const*)original;
+    *(int32_t**)copy = box;
+}
+
+static void map_clones_deeply_when_asked() {
+    TinyMap map = {0};
+
+    for (int32_t i = 0; i < 100; i++) {
+        int32_t* box = StAlloc(sizeof(*box));
+        *box = i;
+        TinyMapPut(&map, i, &box, sizeof(box))->cleanup = free_boxed_int;
+    }
+    TinyMapEnableFilter(&map);
+
+    TinyMap clone = TinyMapClone(&map, copy_boxed_int);
+    assert_eq(clone.filter != NULL, true);
+
+    for (int32_t i = 0; i < 100; i++) {
+        int32_t* const* original = (int32_t**)TinyMapGet(&map, i);
+        int32_t* const* copy = (int32_t**)TinyMapGet(&clone, i);
+        assert_eq(TinyMapFind(&clone, i)->cleanup, free_boxed_int);
+        assert_eq(*copy != *original, true);
+        assert_eq(**copy, i);
+    }
+
+    // each map releases its own boxes, which the leak check at the end of the test verifies:
+    FreeTinyMap(&map);
+    assert_eq(**(int32_t**)TinyMapGet(&clone, 42), 42);
+    FreeTinyMap(&clone);
+}
+
+static void map_merges_by_policy() {
+    TinyMap dst = {0}, src = {0};
+
+    for (int32_t i = 0; i < 100; i++)
+        TinyMapPut(&dst, i, &i, sizeof(i));
+
+    for (int32_t i = 50; i < 150; i++) {
+        const int64_t data = -i;
+        TinyMapPut(&src, i, &data, i % 2 ? sizeof(int64_t) : sizeof(int32_t));
+    }
+
+    TinyMap kept = TinyMapClone(&dst, NULL);
+    TinyMapMerge(&kept, &src, ST_MERGE_KEEP, NULL);
+    assert_eq(TinyMapLength(&kept), 150);
+
+    for (int32_t i = 0; i < 150; i++)
+        assert_eq(TinyMapGetI32(&kept, i), i < 100 ? i : -i);
+
+    TinyMapMerge(&dst, &src, ST_MERGE_OVERWRITE, NULL);
+    assert_eq(TinyMapLength(&dst), 150);
+
+    for (int32_t i = 0; i < 150; i++) {
+        assert_eq(TinyMapGetI32(&dst, i), i < 50 ? i : -i);
+        assert_eq(TinyMapFind(&dst, i)->data_size, i >= 50 && i % 2 ? 8 : 4);
+    }
+
+    FreeTinyMap(&kept), FreeTinyMap(&src), FreeTinyMap(&dst);
+}
+
+static void map_frees_merged_data_once() {
+    // slab ownership is tracked by the map, so buckets stay as small as they were:
+    assert_eq(sizeof(TinyBucket), sizeof(TinyHash) + 2 * sizeof(void*) + sizeof(size_t));
+
+    TinyMap dst = {0};
+
+    // merging data of a different size packs it into another slab every time:
+    for (int32_t round = 0; round < 8; round++) {
+        TinyMap src = {0};
+
+        for (int32_t i = 0; i < 50; i++) {
+            const int64_t data = round;
+            TinyMapPut(&src, i, &data, round % 2 ? sizeof(int64_t) : sizeof(int32_t));
+        }
+
+        TinyMapMerge(&dst, &src, ST_MERGE_OVERWRITE, NULL);
+        FreeTinyMap(&src);
+    }
+
+    assert_eq(TinyDLength(dst.slabs), 8);
+
+    // resizing & erasing slab-backed entries must leave the slabs to `FreeTinyMap`:
+    for (int32_t i = 0; i < 50; i++) {
+        const int16_t data = (int16_t)-i;
+
+        if (i % 2)
+            TinyMapErase(&dst, i);
+        else
+            TinyMapPut(&dst, i, &data, sizeof(data));
+    }
+
+    assert_eq(TinyMapLength(&dst), 25);
+    assert_eq(*(int16_t*)TinyMapGet(&dst, 42), -42);
+
+    FreeTinyMap(&dst);
+}
+
 static void test_hashmaps() {
     run_test(map_simple_put_retrieve);
     run_test(map_string_key_and_nuke);
@@ -161,6 +438,16 @@ static void test_hashmaps() {
     run_test(map_counts_length_correctly);
     run_test(map_overwrites_values_on_put);
     run_test(map_safe_to_reuse);
+    run_test(map_filter_rejects_misses);
+    run_test(map_filter_survives_erases);
+    run_test(map_clones_independently);
+    run_test(map_clones_deeply_when_asked);
+    run_test(map_merges_by_policy);
+    run_test(map_frees_merged_data_once);
+#ifdef S_TRUCTURES_THREADS
+    run_test(map_builds_in_parallel);
+    run_test(map_iterates_in_parallel);
+#endif
     // TODO: test nukes...
 }
 
@@ -238,6 +525,120 @@ static void d_erases() {
     FreeTinyD(da);
 }
 
+static int cmp_ints(const void* a, const void* b) {
+    return *(const int*)a - *(const int*)b;
+}
+
+static void heap_pops_in_order() {
+    const int count = 1000;
+    TinyHeap heap = MakeTinyHeap(int, cmp_ints);
+
+    // a permutation of [0; count), since 7 and 1000 are coprime:
+    for (int i = 0; i < count; i++) {
+        const int value = (i * 7) % count;
+        TinyHeapPush(&heap, &value);
+    }
+
+    assert_eq(TinyHeapLength(&heap), count);
+    assert_eq(*(int*)TinyHeapPeek(&heap), 0);
+
+    for (int i = 0; i < count; i++) {
+        int out = -1;
+        assert_eq(TinyHeapPop(&heap, &out), true);
+        assert_eq(out, i);
+    }
+
+    assert_eq(TinyHeapPeek(&heap), NULL);
+    assert_eq(TinyHeapPop(&heap, NULL), false);
+
+    FreeTinyHeap(&heap);
+}
+
+static void heap_updates_by_handle() {
+    TinyHeap heap = MakeTinyHeapPro(sizeof(int), 3, cmp_ints);
+    TinyHeapHandle handles[100];
+
+    for (int i = 0; i < 100; i++) {
+        const int value = 1000 + i;
+        handles[i] = TinyHeapPush(&heap, &value);
+    }
+
+    const int lower = 5, higher = 5000;
+    assert_eq(TinyHeapUpdate(&heap, handles[50], &lower), true);
+    assert_eq(*(int*)TinyHeapPeek(&heap), lower);
+
+    assert_eq(TinyHeapUpdate(&heap, handles[50], &higher), true);
+    assert_eq(*(int*)TinyHeapGet(&heap, handles[50]), higher);
+    assert_eq(*(int*)TinyHeapPeek(&heap), 1000);
+
+    int out = -1;
+    assert_eq(TinyHeapPop(&heap, &out), true);
+    assert_eq(out, 1000);
+    assert_eq(TinyHeapGet(&heap, handles[0]), NULL);
+    assert_eq(TinyHeapUpdate(&heap, handles[0], &lower), false);
+
+    // storage of popped elements gets reused, but their handles stay stale:
+    const TinyHeapHandle reused = TinyHeapPush(&heap, &lower);
+    assert_eq(reused != handles[0], true);
+    assert_eq(*(int*)TinyHeapGet(&heap, reused), lower);
+    assert_eq(TinyHeapGet(&heap, handles[0]), NULL);
+    assert_eq(TinyHeapUpdate(&heap, handles[0], &higher), false);
+    assert_eq(*(int*)TinyHeapPeek(&heap), lower);
+
+    for (int i = 1; i < 100; i++)
+        if (i != 50)
+            assert_eq(*(int*)TinyHeapGet(&heap, handles[i]), 1000 + i);
+
+    FreeTinyHeap(&heap);
+}
+
+static void heap_heapifies_tinyDs() {
+    int* da = MakeTinyD(int);
+    for (int i = 0; i < 500; i++)
+        da = TinyDAppend(da, 499 - i);
+
+    TinyHeap heap = TinyHeapFrom(da, ST_TINY_HEAP_ARITY, cmp_ints);
+    assert_eq(*(int*)TinyHeapGet(&heap, 0), 499);
+
+    for (int i = 0; i < 500; i++) {
+        int out = -1;
+        TinyHeapPop(&heap, &out);
+        assert_eq(out, i);
+    }
+
+    FreeTinyHeap(&heap);
+}
+
+#define IntGreater(a, b) ((a) > (b))
+ST_DEFINE_TINY_HEAP(MaxHeap, int, IntGreater)
+
+static void heap_specializes_at_compile_time() {
+    int* heap = MakeTinyD(int);
+
+    for (int i = 0; i < 300; i++)
+        heap = MaxHeapPush(heap, (i * 7) % 300);
+
+    for (int i = 299; i >= 0; i--) {
+        assert_eq(heap[0], i);
+        heap = MaxHeapPop(heap);
+    }
+    assert_eq(TinyDLength(heap), 0);
+
+    for (int i = 0; i < 300; i++)
+        heap = TinyDAppend(heap, i);
+    heap = MaxHeapHeapify(heap);
+    assert_eq(heap[0], 299);
+
+    FreeTinyD(heap);
+}
+
+static void test_heaps() {
+    run_test(heap_pops_in_order);
+    run_test(heap_updates_by_handle);
+    run_test(heap_heapifies_tinyDs);
+    run_test(heap_specializes_at_compile_time);
+}
+
 static void test_tinyDs() {
     run_test(d_append_doesnt_crash);
     run_test(d_pops_back);
@@ -245,8 +646,305 @@ static void test_tinyDs() {
     run_test(d_erases);
 }
 
+static void interner_dedups_strings() {
+    StInterner interner = {0};
+
+    const StStrId hello = StInternStr(&interner, "hello");
+    const StStrId world = StInternStr(&interner, "world");
+    assert_eq(hello, 0);
+    assert_eq(world, 1);
+
+    assert_eq(StInternStr(&interner, "hello"), hello);
+    assert_eq(StIntern(&interner, "hello, world", 5), hello);
+    assert_eq(StInternerLength(&interner), 2);
+
+    assert_eq(StInternerFind(&interner, "world!", 5), world);
+    assert_eq(StInternerFind(&interner, "nope", 4), ST_STR_ID_NONE);
+    assert_eq(StInternerLength(&interner), 2);
+
+    FreeStInterner(&interner);
+    assert_eq(StInternerLength(&interner), 0);
+    assert_eq(StInternerFind(&interner, "hello", 5), ST_STR_ID_NONE);
+}
+
+static void interner_keeps_strings_and_hashes() {
+    const size_t count = 10000;
+    StInterner interner = {0};
+
+    char buf[32];
+    for (size_t i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "asset_%zu", i);
+        assert_eq(StInternStr(&interner, buf), i);
+    }
+
+    // one string that doesn't fit into a regular arena chunk:
+    char* big = malloc(3 * ST_INTERNER_CHUNK_SIZE);
+    memset(big, 'x', 3 * ST_INTERNER_CHUNK_SIZE - 1), big[3 * ST_INTERNER_CHUNK_SIZE - 1] = '\0';
+    const StStrId big_id = StInternStr(&interner, big);
+    assert_eq(StInternerStrLength(&interner, big_id), 3 * ST_INTERNER_CHUNK_SIZE - 1);
+    assert_eq(strcmp(StInternerStr(&interner, big_id), big), 0);
+    free(big);
+
+    const StStrId empty = StInternStr(&interner, "");
+    assert_eq(StInternerStrLength(&interner, empty), 0);
+    assert_eq(StInternerStr(&interner, empty)[0], '\0');
+
+    for (size_t i = 0; i < count; i++) {
+        snprintf(buf, sizeof(buf), "asset_%zu", i);
+        assert_eq(strcmp(StInternerStr(&interner, i), buf), 0);
+        assert_eq(StInternerHash(&interner, i), StHashStr(buf));
+    }
+
+    assert_eq(StInternerStr(&interner, ST_STR_ID_NONE), NULL);
+
+    FreeStInterner(&interner);
+}
+
+static void interner_hashes_work_with_maps() {
+    StInterner interner = {0};
+    TinyMap map = {0};
+
+    const int32_t data = 42;
+    TinyDictPut(&map, "player", &data, sizeof(data));
+
+    const StStrId player = StInternStr(&interner, "player");
+    assert_eq(TinyMapGetI32(&map, StInternerHash(&interner, player)), data);
+
+    FreeTinyMap(&map);
+    FreeStInterner(&interner);
+}
+
+static void interner_recovers_map_keys() {
+    StInterner interner = {0};
+    TinyMap map = {0};
+    char buf[32];
+
+    for (int32_t i = 0; i < 1000; i++) {
+        snprintf(buf, sizeof(buf), "key%d", (int)i);
+        TinyMapPut(&map, StInternerHash(&interner, StInternStr(&interner, buf)), &i, sizeof(i));
+    }
+
+    size_t seen = 0;
+    TINY_MAP_FOREACH (&map, it) {
+        const StStrId id = StInternerFindHash(&interner, it.bucket->hash);
+        snprintf(buf, sizeof(buf), "key%d", (int)*(int32_t*)it.data);
+        assert_eq(strcmp(StInternerStr(&interner, id), buf), 0);
+        seen++;
+    }
+
+    assert_eq(seen, 1000);
+    assert_eq(StInternerFindHash(&interner, StHashStr("nope")), ST_STR_ID_NONE);
+
+    FreeTinyMap(&map);
+    FreeStInterner(&interner);
+    assert_eq(StInternerFindHash(&interner, StHashStr("key0")), ST_STR_ID_NONE);
+}
+
+static void test_interners() {
+    run_test(interner_dedups_strings);
+    run_test(interner_keeps_strings_and_hashes);
+    run_test(interner_hashes_work_with_maps);
+    run_test(interner_recovers_map_keys);
+}
+
+#ifdef S_TRUCTURES_THREADS
+
+static void spsc_pushes_and_pops() {
+    TinySpscQ* q = MakeTinySpscQ(int64_t, 5);
+    assert_eq(TinySpscQCapacity(q), 8);
+
+    // go around the ring a couple of times:
+    for (int64_t lap = 0; lap < 3; lap++) {
+        for (int64_t i = 0; i < 8; i++)
+            assert_eq(TinySpscQPush(q, &i), true);
+
+        const int64_t extra = 8;
+        assert_eq(TinySpscQPush(q, &extra), false);
+
+        for (int64_t i = 0; i < 8; i++) {
+            int64_t out = -1;
+            assert_eq(TinySpscQPop(q, &out), true);
+            assert_eq(out, i);
+        }
+
+        int64_t out = -1;
+        assert_eq(TinySpscQPop(q, &out), false);
+    }
+
+    FreeTinySpscQ(q);
+}
+
+static void spsc_batches_wrap_around() {
+    TinySpscQ* q = MakeTinySpscQ(int32_t, 8);
+    int32_t in[12], out[12];
+
+    for (int32_t i = 0; i < 12; i++)
+        in[i] = i;
+
+    assert_eq(TinySpscQPushMany(q, in, 5), 5);
+    assert_eq(TinySpscQPopMany(q, out, 5), 5);
+
+    // only 8 fit, and they straddle the end of the ring:
+    assert_eq(TinySpscQPushMany(q, in, 12), 8);
+    assert_eq(TinySpscQPopMany(q, out, 12), 8);
+
+    for (int32_t i = 0; i < 8; i++)
+        assert_eq(out[i], i);
+
+    FreeTinySpscQ(q);
+}
+
+#define QUEUE_TEST_ITEMS ((size_t)100000)
+
+static int spsc_producer(void* arg) {
+    TinySpscQ* q = arg;
+
+    for (size_t i = 1; i <= QUEUE_TEST_ITEMS;)
+        if (TinySpscQPush(q, &i))
+            i++;
+        else
+            thrd_yield();
+
+    return 0;
+}
+
+static void spsc_survives_two_threads() {
+    TinySpscQ* q = MakeTinySpscQ(size_t, 64);
+
+    thrd_t producer;
+    assert_eq(thrd_create(&producer, spsc_producer, q), thrd_success);
+
+    for (size_t expected = 1; expected <= QUEUE_TEST_ITEMS;) {
+        size_t out[16];
+        const size_t popped = TinySpscQPopMany(q, out, 16);
+
+        if (!popped)
+            thrd_yield();
+        for (size_t i = 0; i < popped; i++)
+            assert_eq(out[i], expected++);
+    }
+
+    thrd_join(producer, NULL);
+    FreeTinySpscQ(q);
+}
+
+static void mpmc_pushes_and_pops() {
+    TinyMpmcQ* q = MakeTinyMpmcQ(int16_t, 4);
+    int16_t in[6] = {1, 2, 3, 4, 5, 6}, out[6] = {0};
+
+    assert_eq(TinyMpmcQPushMany(q, in, 6), 4);
+    assert_eq(TinyMpmcQPush(q, &in[4]), false);
+
+    assert_eq(TinyMpmcQPop(q, &out[0]), true);
+    assert_eq(out[0], 1);
+    assert_eq(TinyMpmcQPush(q, &in[4]), true);
+
+    assert_eq(TinyMpmcQPopMany(q, out, 6), 4);
+    for (int i = 0; i < 4; i++)
+        assert_eq(out[i], in[i + 1]);
+
+    assert_eq(TinyMpmcQPop(q, &out[0]), false);
+
+    FreeTinyMpmcQ(q);
+}
+
+static void queues_accept_empty_batches() {
+    TinySpscQ* spsc = MakeTinySpscQ(int, 4);
+    TinyMpmcQ* mpmc = MakeTinyMpmcQ(int, 4);
+    int x = 1, out = 0;
+
+    // zero-sized batches on empty, partially filled, and full queues:
+    for (int i = 0; i < 5; i++) {
+        assert_eq(TinySpscQPushMany(spsc, &x, 0), 0);
+        assert_eq(TinySpscQPopMany(spsc, &out, 0), 0);
+        assert_eq(TinyMpmcQPushMany(mpmc, &x, 0), 0);
+        assert_eq(TinyMpmcQPopMany(mpmc, &out, 0), 0);
+
+        if (i < 4)
+            TinySpscQPush(spsc, &x), TinyMpmcQPush(mpmc, &x);
+    }
+
+    assert_eq(TinySpscQPopMany(spsc, &out, 0), 0);
+    assert_eq(TinyMpmcQPopMany(mpmc, &out, 0), 0);
+
+    FreeTinySpscQ(spsc), FreeTinyMpmcQ(mpmc);
+}
+
+#define MPMC_TEST_THREADS (4)
+
+typedef struct {
+    TinyMpmcQ* q;
+    atomic_size_t* popped;
+    atomic_size_t* sum;
+} MpmcTestCtx;
+
+static int mpmc_producer(void* arg) {
+    const MpmcTestCtx* ctx = arg;
+
+    for (size_t i = 1; i <= QUEUE_TEST_ITEMS;) {
+        const size_t batch[2] = {i, i + 1};
+        const size_t pushed = TinyMpmcQPushMany(ctx->q, batch, i < QUEUE_TEST_ITEMS ? 2 : 1);
+
+        if (!pushed)
+            thrd_yield();
+        i += pushed;
+    }
+
+    return 0;
+}
+
+static int mpmc_consumer(void* arg) {
+    const MpmcTestCtx* ctx = arg;
+
+    while (atomic_load(ctx->popped) < MPMC_TEST_THREADS * QUEUE_TEST_ITEMS) {
+        size_t out[3];
+        const size_t popped = TinyMpmcQPopMany(ctx->q, out, 3);
+
+        if (!popped)
+            thrd_yield();
+        for (size_t i = 0; i < popped; i++)
+            atomic_fetch_add(ctx->sum, out[i]);
+        atomic_fetch_add(ctx->popped, popped);
+    }
+
+    return 0;
+}
+
+static void mpmc_survives_many_threads() {
+    atomic_size_t popped = 0, sum = 0;
+    MpmcTestCtx ctx = {.q = MakeTinyMpmcQ(size_t, 128), .popped = &popped, .sum = &sum};
+
+    thrd_t threads[2 * MPMC_TEST_THREADS];
+    for (int i = 0; i < MPMC_TEST_THREADS; i++) {
+        assert_eq(thrd_create(&threads[2 * i], mpmc_producer, &ctx), thrd_success);
+        assert_eq(thrd_create(&threads[2 * i + 1], mpmc_consumer, &ctx), thrd_success);
+    }
+
+    for (int i = 0; i < 2 * MPMC_TEST_THREADS; i++)
+        thrd_join(threads[i], NULL);
+
+    assert_eq(popped, MPMC_TEST_THREADS * QUEUE_TEST_ITEMS);
+    assert_eq(sum, MPMC_TEST_THREADS * QUEUE_TEST_ITEMS * (QUEUE_TEST_ITEMS + 1) / 2);
+
+    FreeTinyMpmcQ(ctx.q);
+}
+
+static void test_queues() {
+    run_test(spsc_pushes_and_pops);
+    run_test(spsc_batches_wrap_around);
+    run_test(spsc_survives_two_threads);
+    run_test(mpmc_pushes_and_pops);
+    run_test(queues_accept_empty_batches);
+    run_test(mpmc_survives_many_threads);
+}
+
+#endif
+
 int main(int argc, char* argv[]) {
-    test_hashmaps(), test_tinyDs();
+    test_hashmaps(), test_tinyDs(), test_heaps(), test_interners();
+#ifdef S_TRUCTURES_THREADS
+    test_queues();
+#endif
     printf("All good!\n"), fflush(stdout);
     return EXIT_SUCCESS;
 }